@@ -2,6 +2,7 @@
 #define AC_HASH_HPP
 
 #include <vector>
+#include <array>
 #include <string>
 #include <cstdint>
 #include <sstream>
@@ -12,103 +13,192 @@
 const size_t HASH_SIZE_BITS = 256;
 const size_t HASH_SIZE_BYTES = 32; // 256 / 8
 
-class CellularAutomaton1D {
-private:
-    uint8_t state[HASH_SIZE_BYTES];
-    uint8_t next_state[HASH_SIZE_BYTES];
-    uint8_t rule;
-    uint8_t rule_lookup[8];
-
-    void init_rule_lookup() {
-        for (int i = 0; i < 8; ++i) {
-            rule_lookup[i] = (rule >> i) & 1;
+// --- OPTIMISATION v6 : etat "bitslice" sur 4 mots de 64 bits ---
+// Les 256 cellules sont rangees en big-endian : la cellule 0 est le bit de
+// poids fort du mot 0, exactement comme le bit de poids fort de l'octet 0
+// dans la version octet par octet. Une generation complete se calcule avec
+// quelques decalages/rotations et une formule booleenne sur 64 cellules a la fois.
+const size_t HASH_SIZE_WORDS = HASH_SIZE_BITS / 64;
+
+// Valeur speciale du parametre 'Rule' : la regle n'est connue qu'a l'execution.
+const int AC_RULE_DYNAMIC = -1;
+
+/**
+ * @brief Coefficient du monome 'm' dans la forme normale algebrique (ANF) de la regle :
+ * f(L,C,R) = a0 ^ aL.L ^ aC.C ^ aR.R ^ aLC.L.C ^ aLR.L.R ^ aCR.C.R ^ aLCR.L.C.R
+ * Transformee de Mobius : XOR des sorties de la regle pour tous les motifs inclus
+ * dans 'm' (bit 2 = L, bit 1 = C, bit 0 = R, comme 'pattern' dans q1.cpp).
+ */
+constexpr uint64_t ac_rule_anf_mask(int rule, int m) {
+    int coef = 0;
+    for (int p = 0; p < 8; ++p) {
+        if ((p & m) == p) {
+            coef ^= (rule >> p) & 1;
+        }
+    }
+    return coef ? ~uint64_t(0) : 0;
+}
+
+// --- OPTIMISATION v7 : regle specialisee a la compilation ---
+// CARule<Rule>::apply() calcule la nouvelle valeur de 64 cellules a la fois.
+// Pour une regle connue a la compilation, les masques ANF sont des constantes :
+// le compilateur supprime les termes nuls et il ne reste qu'une formule fixe.
+template <int Rule>
+struct CARule {
+    static_assert(Rule >= 0 && Rule <= 255, "Une regle de Wolfram tient sur 8 bits.");
+
+    void set_rule(uint8_t r) {
+        if (r != Rule) {
+            throw std::invalid_argument("Regle differente de celle fixee a la compilation.");
         }
     }
 
-    inline bool get_bit(const uint8_t* data, size_t bit_index) const {
-        size_t byte_index = bit_index >> 3;
-        size_t bit_offset = 7 - (bit_index & 7);
-        return (data[byte_index] >> bit_offset) & 1;
+    inline uint64_t apply(uint64_t l, uint64_t c, uint64_t r) const {
+        return ac_rule_anf_mask(Rule, 0)
+             ^ (ac_rule_anf_mask(Rule, 4) & l) ^ (ac_rule_anf_mask(Rule, 2) & c)
+             ^ (ac_rule_anf_mask(Rule, 1) & r) ^ (ac_rule_anf_mask(Rule, 6) & (l & c))
+             ^ (ac_rule_anf_mask(Rule, 5) & (l & r)) ^ (ac_rule_anf_mask(Rule, 3) & (c & r))
+             ^ (ac_rule_anf_mask(Rule, 7) & (l & c & r));
+    }
+};
+
+// Regles mesurees dans q7.cpp : formules ecrites a la main.
+template <> inline uint64_t CARule<30>::apply(uint64_t l, uint64_t c, uint64_t r) const {
+    return l ^ (c | r);
+}
+
+template <> inline uint64_t CARule<90>::apply(uint64_t l, uint64_t, uint64_t r) const {
+    return l ^ r;
+}
+
+template <> inline uint64_t CARule<110>::apply(uint64_t l, uint64_t c, uint64_t r) const {
+    return (c ^ r) | (c & ~l);
+}
+
+// Cas general : masques ANF calcules a l'execution (toujours sans branche ni table).
+template <>
+struct CARule<AC_RULE_DYNAMIC> {
+    uint64_t anf[8];
+
+    CARule() { set_rule(0); }
+
+    void set_rule(uint8_t r) {
+        for (int m = 0; m < 8; ++m) {
+            anf[m] = ac_rule_anf_mask(r, m);
+        }
     }
 
-    // --- OPTIMISATION v5 (1/2) : 'set_bit' sans branche ---
-    // Supprime le 'if-else', qui est lent pour le CPU.
-    // Utilise la logique binaire pour forcer le bit à 0 ou 1.
-    inline void set_bit(uint8_t* data, size_t bit_index, bool value) {
-        size_t byte_index = bit_index >> 3;
-        size_t bit_offset = 7 - (bit_index & 7);
-        uint8_t mask = 1 << bit_offset;
-        
-        // (data & ~mask) -> met le bit à 0
-        // (value << bit_offset) -> met le bit à 'value'
-        data[byte_index] = (data[byte_index] & ~mask) | (value << bit_offset);
+    inline uint64_t apply(uint64_t l, uint64_t c, uint64_t r) const {
+        uint64_t lc = l & c;
+        return anf[0]
+             ^ (anf[4] & l)  ^ (anf[2] & c)  ^ (anf[1] & r)
+             ^ (anf[6] & lc) ^ (anf[5] & (l & r)) ^ (anf[3] & (c & r))
+             ^ (anf[7] & (lc & r));
     }
-    // --- FIN OPTIMISATION ---
+};
+// --- FIN OPTIMISATION ---
+
+// --- Largeur de l'automate en parametre (128, 256, 512, 1024 cellules...) ---
+// Le meme noyau mot par mot s'applique a n'importe quel multiple de 64
+// cellules ; la largeur par defaut (256) est celle de ac_hash().
+template <int Rule = AC_RULE_DYNAMIC, size_t Bits = HASH_SIZE_BITS>
+class CellularAutomaton1D {
+    static_assert(Bits >= 64 && Bits % 64 == 0, "La largeur de l'automate est un multiple de 64 cellules.");
+
+public:
+    static const size_t WORDS = Bits / 64;
+    static const size_t BYTES = Bits / 8;
+
+private:
+    uint64_t state[WORDS];
+    mutable uint8_t state_bytes[BYTES];
+    CARule<Rule> kernel;
 
 public:
     CellularAutomaton1D() {
-        std::memset(state, 0, HASH_SIZE_BYTES);
-        std::memset(next_state, 0, HASH_SIZE_BYTES);
+        std::memset(state, 0, sizeof(state));
+        std::memset(state_bytes, 0, BYTES);
     }
 
     void set_rule(uint8_t r) { 
-        this->rule = r;
-        init_rule_lookup();
+        kernel.set_rule(r);
     }
 
     void init_state(const uint8_t* bits, size_t size) {
-        std::memset(state, 0, HASH_SIZE_BYTES);
-        size_t copy_size = (size < HASH_SIZE_BYTES) ? size : HASH_SIZE_BYTES;
-        std::memcpy(state, bits, copy_size);
+        uint8_t buffer[BYTES];
+        std::memset(buffer, 0, BYTES);
+        size_t copy_size = (size < BYTES) ? size : BYTES;
+        std::memcpy(buffer, bits, copy_size);
+
+        // Lecture big-endian : l'octet 0 devient les 8 bits de poids fort du mot 0.
+        for (size_t w = 0; w < WORDS; ++w) {
+            uint64_t word = 0;
+            for (size_t b = 0; b < 8; ++b) {
+                word = (word << 8) | buffer[w * 8 + b];
+            }
+            state[w] = word;
+        }
+    }
+
+    /**
+     * @brief XOR de 'size' octets dans les premieres cellules (meme ordre
+     * big-endian que init_state) : absorption d'un bloc par l'eponge.
+     */
+    void absorb(const uint8_t* bytes, size_t size) {
+        for (size_t i = 0; i < size && i < BYTES; ++i) {
+            state[i / 8] ^= static_cast<uint64_t>(bytes[i]) << (56 - 8 * (i % 8));
+        }
     }
 
-    // --- OPTIMISATION v5 (2/2) : Boucle 'evolve' sans branche ---
     void evolve() {
-        // HASH_SIZE_BITS - 1 = 255 (en binaire: 11111111)
-        const size_t mask = HASH_SIZE_BITS - 1;
-
-        for (size_t bit_idx = 0; bit_idx < HASH_SIZE_BITS; ++bit_idx) {
-            
-            // Remplacement des 'if (bit_idx == 0) ? ...' par
-            // un AND bitwise, ce qui est 100x plus rapide.
-            size_t left_idx  = (bit_idx - 1) & mask; // (0-1)&255 = 255
-            size_t right_idx = (bit_idx + 1) & mask; // (255+1)&255 = 0
-            
-            bool left   = get_bit(state, left_idx);
-            bool center = get_bit(state, bit_idx);
-            bool right  = get_bit(state, right_idx);
-            
-            int pattern = (left << 2) | (center << 1) | right;
-            
-            bool new_value = rule_lookup[pattern];
-            set_bit(next_state, bit_idx, new_value);
+        uint64_t next_state[WORDS];
+
+        for (size_t w = 0; w < WORDS; ++w) {
+            // Mots voisins (conditions aux limites periodiques sur 'Bits' cellules)
+            uint64_t prev = state[(w + WORDS - 1) % WORDS];
+            uint64_t next = state[(w + 1) % WORDS];
+
+            // Voisin de gauche de la cellule i = cellule i-1 : on decale vers
+            // les poids faibles et on recupere le dernier bit du mot precedent.
+            uint64_t c = state[w];
+            uint64_t l = (c >> 1) | (prev << 63);
+            uint64_t r = (c << 1) | (next >> 63);
+
+            next_state[w] = kernel.apply(l, c, r);
         }
-        
-        std::memcpy(state, next_state, HASH_SIZE_BYTES);
+
+        std::memcpy(state, next_state, sizeof(state));
     }
-    // --- FIN OPTIMISATION ---
     
     const uint8_t* get_final_state() const { 
-        return state; 
+        for (size_t w = 0; w < WORDS; ++w) {
+            for (size_t b = 0; b < 8; ++b) {
+                state_bytes[w * 8 + b] = static_cast<uint8_t>(state[w] >> (56 - 8 * b));
+            }
+        }
+        return state_bytes; 
     }
 };
 
 
 // --- (Le reste du fichier est identique à v4) ---
 
-inline void string_to_bytes(const std::string& input, uint8_t* output, size_t output_size) {
+inline void string_to_bytes(const uint8_t* input, size_t input_len, uint8_t* output, size_t output_size) {
     std::memset(output, 0, output_size);
     
-    for (size_t i = 0; i < input.length(); ++i) {
-        output[i % output_size] ^= static_cast<uint8_t>(input[i]);
+    for (size_t i = 0; i < input_len; ++i) {
+        output[i % output_size] ^= input[i];
     }
     
-    size_t input_len = input.length();
     for (size_t i = 0; i < sizeof(input_len); ++i) {
         output[i % output_size] ^= static_cast<uint8_t>((input_len >> (i * 8)) & 0xFF);
     }
 }
 
+inline void string_to_bytes(const std::string& input, uint8_t* output, size_t output_size) {
+    string_to_bytes(reinterpret_cast<const uint8_t*>(input.data()), input.length(), output, output_size);
+}
+
 inline std::string bytes_to_hex_string(const uint8_t* bytes, size_t size) {
     static const char hex_chars[] = "0123456789abcdef";
     std::string result;
@@ -122,12 +212,17 @@ inline std::string bytes_to_hex_string(const uint8_t* bytes, size_t size) {
     return result;
 }
 
-inline std::string ac_hash(const std::string& input, uint32_t rule, size_t steps) {
+/**
+ * @brief Calcule l'etat final (32 octets) de l'automate pour une regle fixee
+ * a la compilation, ou pour 'rule' si Rule == AC_RULE_DYNAMIC.
+ */
+template <int Rule>
+inline void ac_hash_bytes(const uint8_t* input, size_t input_len, uint32_t rule, size_t steps, uint8_t* output) {
     uint8_t initial_state[HASH_SIZE_BYTES];
     
-    string_to_bytes(input, initial_state, HASH_SIZE_BYTES);
+    string_to_bytes(input, input_len, initial_state, HASH_SIZE_BYTES);
     
-    CellularAutomaton1D ac;
+    CellularAutomaton1D<Rule> ac;
     ac.set_rule(static_cast<uint8_t>(rule));
     ac.init_state(initial_state, HASH_SIZE_BYTES);
     
@@ -135,7 +230,102 @@ inline std::string ac_hash(const std::string& input, uint32_t rule, size_t steps
         ac.evolve();
     }
     
-    return bytes_to_hex_string(ac.get_final_state(), HASH_SIZE_BYTES);
+    std::memcpy(output, ac.get_final_state(), HASH_SIZE_BYTES);
+}
+
+template <int Rule>
+inline void ac_hash_bytes(const std::string& input, uint32_t rule, size_t steps, uint8_t* output) {
+    ac_hash_bytes<Rule>(reinterpret_cast<const uint8_t*>(input.data()), input.length(), rule, steps, output);
+}
+
+/**
+ * @brief Version specialisee : ac_hash<30>(input, 128).
+ */
+template <int Rule>
+inline std::string ac_hash(const std::string& input, size_t steps) {
+    uint8_t final_state[HASH_SIZE_BYTES];
+    ac_hash_bytes<Rule>(input, static_cast<uint32_t>(Rule), steps, final_state);
+    return bytes_to_hex_string(final_state, HASH_SIZE_BYTES);
+}
+
+/**
+ * @brief Aiguillage a l'execution : les regles 30, 90 et 110 (celles de q7.cpp)
+ * utilisent leur noyau specialise, les autres le noyau generique.
+ */
+inline void ac_hash_bytes(const uint8_t* input, size_t input_len, uint32_t rule, size_t steps, uint8_t* output) {
+    switch (rule) {
+        case 30:  ac_hash_bytes<30>(input, input_len, rule, steps, output); break;
+        case 90:  ac_hash_bytes<90>(input, input_len, rule, steps, output); break;
+        case 110: ac_hash_bytes<110>(input, input_len, rule, steps, output); break;
+        default:  ac_hash_bytes<AC_RULE_DYNAMIC>(input, input_len, rule, steps, output); break;
+    }
+}
+
+inline void ac_hash_bytes(const std::string& input, uint32_t rule, size_t steps, uint8_t* output) {
+    ac_hash_bytes(reinterpret_cast<const uint8_t*>(input.data()), input.length(), rule, steps, output);
+}
+
+/**
+ * @brief Hash binaire (32 octets) : aucune allocation, aucun encodage hexadecimal.
+ * A utiliser dans les boucles chaudes (minage, validation) ; ac_hash() reste
+ * la version hexadecimale pour l'affichage.
+ */
+inline std::array<uint8_t, HASH_SIZE_BYTES> ac_hash_raw(const uint8_t* input, size_t input_len, uint32_t rule, size_t steps) {
+    std::array<uint8_t, HASH_SIZE_BYTES> digest;
+    ac_hash_bytes(input, input_len, rule, steps, digest.data());
+    return digest;
+}
+
+inline std::array<uint8_t, HASH_SIZE_BYTES> ac_hash_raw(const std::string& input, uint32_t rule, size_t steps) {
+    return ac_hash_raw(reinterpret_cast<const uint8_t*>(input.data()), input.length(), rule, steps);
+}
+
+inline std::string ac_hash(const std::string& input, uint32_t rule, size_t steps) {
+    uint8_t final_state[HASH_SIZE_BYTES];
+    ac_hash_bytes(input, rule, steps, final_state);
+    return bytes_to_hex_string(final_state, HASH_SIZE_BYTES);
+}
+
+/**
+ * @brief ac_hash sur un automate de 'WidthBits' cellules, hash des
+ * 'DigestBits' premieres cellules (DigestBits <= WidthBits). L'entree est
+ * repliee sur WidthBits / 8 octets. ac_hash_bytes_width<256, 256> == ac_hash_bytes.
+ * La diffusion d'un bit demande environ WidthBits / 2 generations : un
+ * automate plus large demande plus d'etapes.
+ */
+template <size_t WidthBits, size_t DigestBits, int Rule>
+inline void ac_hash_bytes_width(const uint8_t* input, size_t input_len, uint32_t rule, size_t steps,
+                                uint8_t* output) {
+    static_assert(DigestBits % 8 == 0 && DigestBits <= WidthBits, "Hash plus large que l'automate.");
+    uint8_t initial_state[WidthBits / 8];
+    string_to_bytes(input, input_len, initial_state, WidthBits / 8);
+
+    CellularAutomaton1D<Rule, WidthBits> ac;
+    ac.set_rule(static_cast<uint8_t>(rule));
+    ac.init_state(initial_state, WidthBits / 8);
+    for (size_t i = 0; i < steps; ++i) {
+        ac.evolve();
+    }
+    std::memcpy(output, ac.get_final_state(), DigestBits / 8);
+}
+
+template <size_t WidthBits, size_t DigestBits = WidthBits>
+inline void ac_hash_bytes_width(const uint8_t* input, size_t input_len, uint32_t rule, size_t steps,
+                                uint8_t* output) {
+    switch (rule) {
+        case 30:  ac_hash_bytes_width<WidthBits, DigestBits, 30>(input, input_len, rule, steps, output); break;
+        case 90:  ac_hash_bytes_width<WidthBits, DigestBits, 90>(input, input_len, rule, steps, output); break;
+        case 110: ac_hash_bytes_width<WidthBits, DigestBits, 110>(input, input_len, rule, steps, output); break;
+        default:  ac_hash_bytes_width<WidthBits, DigestBits, AC_RULE_DYNAMIC>(input, input_len, rule, steps, output); break;
+    }
+}
+
+template <size_t WidthBits, size_t DigestBits = WidthBits>
+inline std::array<uint8_t, DigestBits / 8> ac_hash_raw_width(const uint8_t* input, size_t input_len, uint32_t rule,
+                                                             size_t steps) {
+    std::array<uint8_t, DigestBits / 8> digest;
+    ac_hash_bytes_width<WidthBits, DigestBits>(input, input_len, rule, steps, digest.data());
+    return digest;
 }
 
 #endif // AC_HASH_HPP
\ No newline at end of file
@@ -0,0 +1,263 @@
+#ifndef AC_HASH_BATCH_HPP
+#define AC_HASH_BATCH_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+#include "ac_hash.hpp"
+
+// ============================================================================
+// --- OPTIMISATION v8 : ac_hash sur plusieurs messages a la fois (SIMD) ---
+// ============================================================================
+// Les messages a hacher (nonces du minage, boucle de q7.cpp) sont independants.
+// On range les etats de 4, 8 ou 16 automates "en colonnes" : le mot k (32 bits)
+// de chaque automate occupe une voie d'un registre vectoriel. Une generation
+// applique alors les memes decalages et la meme formule ANF a toutes les voies.
+//
+// Le noyau est ecrit une seule fois avec les vecteurs de GCC/Clang
+// (vector_size) et instancie dans des fonctions compilees pour SSE2, AVX2 ou
+// AVX-512 ; le choix se fait a l'execution selon le CPU.
+// La version scalaire ac_hash() reste la reference (voir la verification de q7.cpp).
+
+const size_t AC_BATCH_WORDS = HASH_SIZE_BYTES / 4; // 8 mots de 32 bits
+
+enum class AcBatchBackend {
+    SCALAR,
+    SSE2,   // 4 voies
+    AVX2,   // 8 voies
+    AVX512  // 16 voies
+};
+
+inline const char* ac_batch_backend_name(AcBatchBackend backend) {
+    switch (backend) {
+        case AcBatchBackend::AVX512: return "AVX-512";
+        case AcBatchBackend::AVX2:   return "AVX2";
+        case AcBatchBackend::SSE2:   return "SSE2";
+        case AcBatchBackend::SCALAR: default: return "scalaire";
+    }
+}
+
+#if defined(__GNUC__)
+#define AC_BATCH_HAS_VECTORS 1
+
+typedef uint32_t ac_v4u32  __attribute__((vector_size(16)));
+typedef uint32_t ac_v8u32  __attribute__((vector_size(32)));
+typedef uint32_t ac_v16u32 __attribute__((vector_size(64)));
+
+/**
+ * @brief Fait evoluer 'count' automates (count <= LANES) en parallele.
+ * Toujours inline : le code est genere avec le jeu d'instructions de l'appelant.
+ */
+template <class V, size_t LANES>
+inline __attribute__((always_inline))
+void ac_batch_kernel(const uint8_t (*initial)[HASH_SIZE_BYTES], size_t count,
+                     uint32_t rule, size_t steps, uint8_t (*output)[HASH_SIZE_BYTES]) {
+    V s[AC_BATCH_WORDS];
+    V n[AC_BATCH_WORDS];
+    V anf[8];
+
+    // Transposition : voie 'lane' du vecteur 'k' = mot big-endian k de l'automate 'lane'.
+    for (size_t k = 0; k < AC_BATCH_WORDS; ++k) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            uint32_t word = 0;
+            if (lane < count) {
+                const uint8_t* p = initial[lane] + 4 * k;
+                word = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+            }
+            s[k][lane] = word;
+        }
+    }
+
+    for (int m = 0; m < 8; ++m) {
+        V zero = {};
+        anf[m] = zero + static_cast<uint32_t>(ac_rule_anf_mask(static_cast<uint8_t>(rule), m));
+    }
+
+    for (size_t step = 0; step < steps; ++step) {
+        for (size_t k = 0; k < AC_BATCH_WORDS; ++k) {
+            V prev = s[(k + AC_BATCH_WORDS - 1) % AC_BATCH_WORDS];
+            V next = s[(k + 1) % AC_BATCH_WORDS];
+            V c = s[k];
+            V l = (c >> 1) | (prev << 31);
+            V r = (c << 1) | (next >> 31);
+            V lc = l & c;
+            n[k] = anf[0]
+                 ^ (anf[4] & l)  ^ (anf[2] & c)  ^ (anf[1] & r)
+                 ^ (anf[6] & lc) ^ (anf[5] & (l & r)) ^ (anf[3] & (c & r))
+                 ^ (anf[7] & (lc & r));
+        }
+        for (size_t k = 0; k < AC_BATCH_WORDS; ++k) {
+            s[k] = n[k];
+        }
+    }
+
+    // Transposition inverse vers les 32 octets de chaque hash.
+    for (size_t lane = 0; lane < count; ++lane) {
+        for (size_t k = 0; k < AC_BATCH_WORDS; ++k) {
+            uint32_t word = s[k][lane];
+            output[lane][4 * k]     = static_cast<uint8_t>(word >> 24);
+            output[lane][4 * k + 1] = static_cast<uint8_t>(word >> 16);
+            output[lane][4 * k + 2] = static_cast<uint8_t>(word >> 8);
+            output[lane][4 * k + 3] = static_cast<uint8_t>(word);
+        }
+    }
+}
+
+inline void ac_batch_run_4(const uint8_t (*initial)[HASH_SIZE_BYTES], size_t count,
+                           uint32_t rule, size_t steps, uint8_t (*output)[HASH_SIZE_BYTES]) {
+    ac_batch_kernel<ac_v4u32, 4>(initial, count, rule, steps, output);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AC_BATCH_HAS_X86 1
+
+__attribute__((target("avx2"), noinline))
+inline void ac_batch_run_8(const uint8_t (*initial)[HASH_SIZE_BYTES], size_t count,
+                           uint32_t rule, size_t steps, uint8_t (*output)[HASH_SIZE_BYTES]) {
+    ac_batch_kernel<ac_v8u32, 8>(initial, count, rule, steps, output);
+}
+
+__attribute__((target("avx512f"), noinline))
+inline void ac_batch_run_16(const uint8_t (*initial)[HASH_SIZE_BYTES], size_t count,
+                            uint32_t rule, size_t steps, uint8_t (*output)[HASH_SIZE_BYTES]) {
+    ac_batch_kernel<ac_v16u32, 16>(initial, count, rule, steps, output);
+}
+#endif
+#endif // __GNUC__
+
+/**
+ * @brief Indique si le CPU courant sait executer ce backend. Les backends
+ * vectoriels ne sont detectes que sur x86 ; ailleurs, seul SCALAR est retenu.
+ */
+inline bool ac_batch_backend_supported(AcBatchBackend backend) {
+#if defined(AC_BATCH_HAS_X86)
+    __builtin_cpu_init(); // peut etre appele depuis un initialiseur statique
+#endif
+    switch (backend) {
+        case AcBatchBackend::SCALAR:
+            return true;
+#if defined(AC_BATCH_HAS_X86)
+        case AcBatchBackend::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case AcBatchBackend::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case AcBatchBackend::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Backend le plus large disponible (detecte une seule fois).
+ */
+inline AcBatchBackend ac_batch_best_backend() {
+    static const AcBatchBackend best = []() {
+        if (ac_batch_backend_supported(AcBatchBackend::AVX512)) return AcBatchBackend::AVX512;
+        if (ac_batch_backend_supported(AcBatchBackend::AVX2)) return AcBatchBackend::AVX2;
+        if (ac_batch_backend_supported(AcBatchBackend::SSE2)) return AcBatchBackend::SSE2;
+        return AcBatchBackend::SCALAR;
+    }();
+    return best;
+}
+
+inline size_t ac_batch_lanes(AcBatchBackend backend) {
+    switch (backend) {
+        case AcBatchBackend::AVX512: return 16;
+        case AcBatchBackend::AVX2:   return 8;
+        case AcBatchBackend::SSE2:   return 4;
+        case AcBatchBackend::SCALAR: default: return 1;
+    }
+}
+
+/**
+ * @brief Hache 'n' messages avec un backend impose.
+ * Un backend non supporte par le CPU retombe sur la version scalaire.
+ */
+inline void ac_hash_batch(const std::string* inputs, size_t n, uint32_t rule, size_t steps,
+                          uint8_t (*out)[HASH_SIZE_BYTES], AcBatchBackend backend) {
+    if (!ac_batch_backend_supported(backend)) {
+        backend = AcBatchBackend::SCALAR;
+    }
+
+    const size_t lanes = ac_batch_lanes(backend);
+    if (lanes == 1) {
+        for (size_t i = 0; i < n; ++i) {
+            ac_hash_bytes(inputs[i], rule, steps, out[i]);
+        }
+        return;
+    }
+
+    uint8_t initial[16][HASH_SIZE_BYTES];
+    for (size_t base = 0; base < n; base += lanes) {
+        size_t count = (n - base < lanes) ? (n - base) : lanes;
+        for (size_t lane = 0; lane < count; ++lane) {
+            string_to_bytes(inputs[base + lane], initial[lane], HASH_SIZE_BYTES);
+        }
+
+        switch (backend) {
+#if defined(AC_BATCH_HAS_X86)
+            case AcBatchBackend::AVX512: ac_batch_run_16(initial, count, rule, steps, out + base); break;
+            case AcBatchBackend::AVX2:   ac_batch_run_8(initial, count, rule, steps, out + base); break;
+#endif
+#if defined(AC_BATCH_HAS_VECTORS)
+            case AcBatchBackend::SSE2:   ac_batch_run_4(initial, count, rule, steps, out + base); break;
+#endif
+            default:
+                for (size_t lane = 0; lane < count; ++lane) {
+                    ac_hash_bytes(inputs[base + lane], rule, steps, out[base + lane]);
+                }
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Hache 'n' messages independants ; out[i] recoit l'etat final de inputs[i],
+ * identique octet pour octet a ac_hash(inputs[i], rule, steps).
+ */
+inline void ac_hash_batch(const std::string* inputs, size_t n, uint32_t rule, size_t steps,
+                          uint8_t (*out)[HASH_SIZE_BYTES]) {
+    ac_hash_batch(inputs, n, rule, steps, out, ac_batch_best_backend());
+}
+
+/**
+ * @brief Fait evoluer 'n' etats initiaux deja replies (sortie de
+ * string_to_bytes) : out[i] = etat apres 'steps' generations. Pour les
+ * analyses qui fabriquent directement l'etat (avalanche : un bit inverse).
+ */
+inline void ac_evolve_batch(const uint8_t (*initial)[HASH_SIZE_BYTES], size_t n, uint32_t rule, size_t steps,
+                            uint8_t (*out)[HASH_SIZE_BYTES]) {
+    AcBatchBackend backend = ac_batch_best_backend();
+    const size_t lanes = ac_batch_lanes(backend);
+    for (size_t base = 0; base < n; base += lanes) {
+        size_t count = (n - base < lanes) ? (n - base) : lanes;
+        switch (backend) {
+#if defined(AC_BATCH_HAS_X86)
+            case AcBatchBackend::AVX512: ac_batch_run_16(initial + base, count, rule, steps, out + base); break;
+            case AcBatchBackend::AVX2:   ac_batch_run_8(initial + base, count, rule, steps, out + base); break;
+#endif
+#if defined(AC_BATCH_HAS_VECTORS)
+            case AcBatchBackend::SSE2:   ac_batch_run_4(initial + base, count, rule, steps, out + base); break;
+#endif
+            default:
+                for (size_t lane = 0; lane < count; ++lane) {
+                    CellularAutomaton1D<AC_RULE_DYNAMIC> ac;
+                    ac.set_rule(static_cast<uint8_t>(rule));
+                    ac.init_state(initial[base + lane], HASH_SIZE_BYTES);
+                    for (size_t i = 0; i < steps; ++i) {
+                        ac.evolve();
+                    }
+                    std::memcpy(out[base + lane], ac.get_final_state(), HASH_SIZE_BYTES);
+                }
+                break;
+        }
+    }
+}
+// ============================================================================
+// --- FIN OPTIMISATION ---
+// ============================================================================
+
+#endif // AC_HASH_BATCH_HPP
@@ -0,0 +1,264 @@
+#ifndef AC_HASH_LUT_HPP
+#define AC_HASH_LUT_HPP
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "ac_hash.hpp"
+
+// ============================================================================
+// --- OPTIMISATION v9 : plusieurs generations par consultation de table ---
+// ============================================================================
+// Apres g generations, une cellule ne depend que des g cellules de chaque
+// cote. Un octet de sortie (8 cellules) depend donc d'une fenetre de 8 + 2g
+// cellules : pour g = 4, une table de 2^16 octets donne directement l'octet
+// 4 generations plus tard. Une passe = 32 consultations pour 4 generations.
+// Une seconde table (g = 1, 2^10 entrees) termine les 'steps' non multiples de 4.
+//
+// Les tables sont construites a la premiere utilisation d'une regle puis
+// gardees (64 Ko par regle). Le moteur le plus rapide pour une regle (table,
+// bitslice ANF, noyau dedie, ou scalaire cellule par cellule) est choisi par
+// une mesure faite une seule fois : voir ac_engine_select().
+
+const size_t AC_LUT_GENERATIONS = 4;
+const size_t AC_LUT_WINDOW_BITS = 8 + 2 * AC_LUT_GENERATIONS; // 16
+
+struct AcLutTables {
+    uint8_t gen4[size_t(1) << AC_LUT_WINDOW_BITS];
+    uint8_t gen1[size_t(1) << 10];
+};
+
+/**
+ * @brief Octet obtenu apres 'generations' generations d'une fenetre de
+ * 8 + 2 * generations cellules (cellule la plus a gauche = bit de poids fort).
+ */
+inline uint8_t ac_lut_window_result(uint8_t rule, uint32_t window, size_t generations) {
+    int width = static_cast<int>(8 + 2 * generations);
+    uint32_t cells = window;
+    for (size_t g = 0; g < generations; ++g) {
+        uint32_t next = 0;
+        for (int i = 1; i + 1 < width; ++i) {
+            // Cellule i (i = 0 tout a gauche) : bit (width - 1 - i)
+            uint32_t pattern = (cells >> (width - 1 - i - 1)) & 7; // (gauche, centre, droite)
+            next = (next << 1) | ((rule >> pattern) & 1);
+        }
+        cells = next;
+        width -= 2;
+    }
+    return static_cast<uint8_t>(cells);
+}
+
+/**
+ * @brief Tables de la regle (construites au premier appel, puis partagees ;
+ * thread-safe).
+ */
+inline const AcLutTables& ac_lut_tables(uint8_t rule) {
+    static std::once_flag flags[256];
+    static std::unique_ptr<AcLutTables> tables[256];
+    std::call_once(flags[rule], [rule] {
+        std::unique_ptr<AcLutTables> t(new AcLutTables);
+        for (uint32_t w = 0; w < (uint32_t(1) << AC_LUT_WINDOW_BITS); ++w) {
+            t->gen4[w] = ac_lut_window_result(rule, w, AC_LUT_GENERATIONS);
+        }
+        for (uint32_t w = 0; w < (uint32_t(1) << 10); ++w) {
+            t->gen1[w] = ac_lut_window_result(rule, w, 1);
+        }
+        tables[rule] = std::move(t);
+    });
+    return *tables[rule];
+}
+
+/**
+ * @brief Fait evoluer un etat de 32 octets (meme ordre que ac_hash) par tables.
+ */
+inline void ac_lut_evolve(const AcLutTables& t, uint8_t* state, size_t steps) {
+    // Octets 1..32 = etat ; 0 et 33 = voisins periodiques
+    uint8_t a[HASH_SIZE_BYTES + 2];
+    uint8_t b[HASH_SIZE_BYTES + 2];
+    uint8_t* cur = a;
+    uint8_t* nxt = b;
+    std::memcpy(cur + 1, state, HASH_SIZE_BYTES);
+
+    for (; steps >= AC_LUT_GENERATIONS; steps -= AC_LUT_GENERATIONS) {
+        cur[0] = cur[HASH_SIZE_BYTES];
+        cur[HASH_SIZE_BYTES + 1] = cur[1];
+        for (size_t j = 1; j <= HASH_SIZE_BYTES; ++j) {
+            uint32_t window = (uint32_t(cur[j - 1] & 0x0f) << 12) | (uint32_t(cur[j]) << 4) | (cur[j + 1] >> 4);
+            nxt[j] = t.gen4[window];
+        }
+        std::swap(cur, nxt);
+    }
+    for (; steps > 0; --steps) {
+        cur[0] = cur[HASH_SIZE_BYTES];
+        cur[HASH_SIZE_BYTES + 1] = cur[1];
+        for (size_t j = 1; j <= HASH_SIZE_BYTES; ++j) {
+            uint32_t window = (uint32_t(cur[j - 1] & 0x01) << 9) | (uint32_t(cur[j]) << 1) | (cur[j + 1] >> 7);
+            nxt[j] = t.gen1[window];
+        }
+        std::swap(cur, nxt);
+    }
+    std::memcpy(state, cur + 1, HASH_SIZE_BYTES);
+}
+
+/**
+ * @brief Reference cellule par cellule (comme q1.cpp) : un bit par octet.
+ */
+inline void ac_scalar_evolve(uint8_t rule, uint8_t* state, size_t steps) {
+    uint8_t cells[HASH_SIZE_BITS];
+    uint8_t next[HASH_SIZE_BITS];
+    for (size_t i = 0; i < HASH_SIZE_BITS; ++i) {
+        cells[i] = (state[i / 8] >> (7 - i % 8)) & 1;
+    }
+    for (size_t s = 0; s < steps; ++s) {
+        for (size_t i = 0; i < HASH_SIZE_BITS; ++i) {
+            int pattern = (cells[(i + HASH_SIZE_BITS - 1) % HASH_SIZE_BITS] << 2) | (cells[i] << 1)
+                        | cells[(i + 1) % HASH_SIZE_BITS];
+            next[i] = (rule >> pattern) & 1;
+        }
+        std::memcpy(cells, next, sizeof(cells));
+    }
+    std::memset(state, 0, HASH_SIZE_BYTES);
+    for (size_t i = 0; i < HASH_SIZE_BITS; ++i) {
+        state[i / 8] |= static_cast<uint8_t>(cells[i] << (7 - i % 8));
+    }
+}
+
+enum class AcEngine {
+    SCALAR,          // cellule par cellule
+    BITSLICE_ANF,    // CARule<AC_RULE_DYNAMIC> : 64 cellules par mot
+    BITSLICE_RULE,   // CARule<30/90/110> : formule dediee
+    LUT              // 4 generations par consultation
+};
+
+inline const char* ac_engine_name(AcEngine engine) {
+    switch (engine) {
+        case AcEngine::SCALAR:        return "scalaire";
+        case AcEngine::BITSLICE_ANF:  return "bitslice";
+        case AcEngine::BITSLICE_RULE: return "bitslice_dedie";
+        case AcEngine::LUT:           default: return "table";
+    }
+}
+
+inline bool ac_engine_supported(AcEngine engine, uint32_t rule) {
+    return engine != AcEngine::BITSLICE_RULE || rule == 30 || rule == 90 || rule == 110;
+}
+
+template <int Rule>
+inline void ac_bitslice_evolve(uint32_t rule, uint8_t* state, size_t steps) {
+    CellularAutomaton1D<Rule> ac;
+    ac.set_rule(static_cast<uint8_t>(rule));
+    ac.init_state(state, HASH_SIZE_BYTES);
+    for (size_t i = 0; i < steps; ++i) {
+        ac.evolve();
+    }
+    std::memcpy(state, ac.get_final_state(), HASH_SIZE_BYTES);
+}
+
+/**
+ * @brief Fait evoluer un etat deja replie avec le moteur choisi ; tous les
+ * moteurs donnent le meme resultat.
+ */
+inline void ac_engine_evolve(AcEngine engine, uint32_t rule, uint8_t* state, size_t steps) {
+    switch (engine) {
+        case AcEngine::SCALAR:
+            ac_scalar_evolve(static_cast<uint8_t>(rule), state, steps);
+            break;
+        case AcEngine::LUT:
+            ac_lut_evolve(ac_lut_tables(static_cast<uint8_t>(rule)), state, steps);
+            break;
+        case AcEngine::BITSLICE_RULE:
+            if (rule == 30)  { ac_bitslice_evolve<30>(rule, state, steps); break; }
+            if (rule == 90)  { ac_bitslice_evolve<90>(rule, state, steps); break; }
+            if (rule == 110) { ac_bitslice_evolve<110>(rule, state, steps); break; }
+            ac_bitslice_evolve<AC_RULE_DYNAMIC>(rule, state, steps);
+            break;
+        case AcEngine::BITSLICE_ANF:
+        default:
+            ac_bitslice_evolve<AC_RULE_DYNAMIC>(rule, state, steps);
+            break;
+    }
+}
+
+// Mesure de selection : quelques hashes de 128 generations, meilleur de 3
+const size_t AC_ENGINE_CALIBRATION_HASHES = 16;
+const size_t AC_ENGINE_CALIBRATION_STEPS = 128;
+
+/**
+ * @brief Temps moyen (ns) d'un hash de 128 generations avec ce moteur.
+ * La construction des tables est faite avant la mesure.
+ */
+inline double ac_engine_measure(AcEngine engine, uint32_t rule) {
+    typedef std::chrono::steady_clock Clock;
+    if (engine == AcEngine::LUT) {
+        ac_lut_tables(static_cast<uint8_t>(rule));
+    }
+    uint8_t state[HASH_SIZE_BYTES];
+    for (size_t i = 0; i < HASH_SIZE_BYTES; ++i) {
+        state[i] = static_cast<uint8_t>(i * 73 + 5);
+    }
+    const size_t nHashes = (engine == AcEngine::SCALAR) ? 2 : AC_ENGINE_CALIBRATION_HASHES;
+    double best = 0.0;
+    for (int rep = 0; rep < 3; ++rep) {
+        auto t0 = Clock::now();
+        for (size_t h = 0; h < nHashes; ++h) {
+            ac_engine_evolve(engine, rule, state, AC_ENGINE_CALIBRATION_STEPS);
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / nHashes;
+        best = (rep == 0) ? ns : std::min(best, ns);
+    }
+    asm volatile("" : : "r,m"(state[0]) : "memory");
+    return best;
+}
+
+/**
+ * @brief Moteur le plus rapide pour la regle (mesure au premier appel, puis
+ * memorise ; thread-safe).
+ */
+inline AcEngine ac_engine_select(uint8_t rule) {
+    static std::once_flag flags[256];
+    static AcEngine selected[256];
+    std::call_once(flags[rule], [rule] {
+        AcEngine best = AcEngine::BITSLICE_ANF;
+        double bestNs = ac_engine_measure(best, rule);
+        for (AcEngine engine : {AcEngine::BITSLICE_RULE, AcEngine::LUT}) {
+            if (!ac_engine_supported(engine, rule)) {
+                continue;
+            }
+            double ns = ac_engine_measure(engine, rule);
+            if (ns < bestNs) {
+                best = engine;
+                bestNs = ns;
+            }
+        }
+        selected[rule] = best;
+    });
+    return selected[rule];
+}
+
+/**
+ * @brief Meme resultat que ac_hash_bytes(), avec le moteur impose.
+ */
+inline void ac_hash_bytes_engine(AcEngine engine, const uint8_t* input, size_t input_len, uint32_t rule,
+                                 size_t steps, uint8_t* output) {
+    string_to_bytes(input, input_len, output, HASH_SIZE_BYTES);
+    ac_engine_evolve(engine, rule, output, steps);
+}
+
+/**
+ * @brief Meme resultat que ac_hash_bytes(), avec le moteur le plus rapide
+ * mesure pour cette regle.
+ */
+inline void ac_hash_bytes_auto(const uint8_t* input, size_t input_len, uint32_t rule, size_t steps,
+                               uint8_t* output) {
+    ac_hash_bytes_engine(ac_engine_select(static_cast<uint8_t>(rule)), input, input_len, rule, steps, output);
+}
+// ============================================================================
+// --- FIN OPTIMISATION ---
+// ============================================================================
+
+#endif // AC_HASH_LUT_HPP
@@ -0,0 +1,146 @@
+#ifndef AC_SPONGE_HPP
+#define AC_SPONGE_HPP
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+#include "ac_hash.hpp"
+
+/**
+ * AcHasher : ac_hash en construction éponge, pour les longues entrées.
+ *
+ * ac_hash() replie toute l'entrée par XOR dans 32 octets puis fait évoluer
+ * l'automate : il faut toute l'entrée en mémoire, et deux octets distants
+ * d'un multiple de 32 s'annulent. Ici l'état de 256 cellules est découpé
+ * en un débit de 16 octets (cellules 0..127) et une capacité de 16 octets :
+ *
+ * - update() : chaque bloc de 16 octets est XORé dans le débit, puis
+ *   l'automate avance de 'roundsPerBlock' générations. Mémoire constante,
+ *   l'entrée peut arriver par morceaux de taille quelconque.
+ * - finalize() : bourrage 10*1, absorption du dernier bloc, 'finalSteps'
+ *   générations, puis extraction 16 octets par 16 octets.
+ *
+ * La règle et les paramètres sont injectés dans la capacité au départ :
+ * deux configurations différentes ne partagent pas d'état. ac_hash() n'est
+ * pas modifié (les chaînes existantes en dépendent) : AcHasher est une
+ * fonction de hachage distincte.
+ */
+
+const size_t AC_SPONGE_RATE_BYTES = 16;
+const size_t AC_SPONGE_DEFAULT_ROUNDS = 32;  // générations entre deux blocs
+const size_t AC_SPONGE_DEFAULT_FINAL_STEPS = 128;
+
+template <int Rule = AC_RULE_DYNAMIC>
+class AcHasher {
+private:
+    CellularAutomaton1D<Rule> _ac;
+    uint32_t _nRule;
+    size_t _nRoundsPerBlock;
+    size_t _nFinalSteps;
+    uint8_t _buffer[AC_SPONGE_RATE_BYTES];
+    size_t _nBuffered;
+
+    void _Evolve(size_t generations) {
+        for (size_t i = 0; i < generations; ++i) {
+            _ac.evolve();
+        }
+    }
+
+    void _AbsorbBlock(const uint8_t* block) {
+        _ac.absorb(block, AC_SPONGE_RATE_BYTES);
+        _Evolve(_nRoundsPerBlock);
+    }
+
+public:
+    explicit AcHasher(uint32_t rule = (Rule == AC_RULE_DYNAMIC ? 30 : Rule),
+                      size_t roundsPerBlock = AC_SPONGE_DEFAULT_ROUNDS,
+                      size_t finalSteps = AC_SPONGE_DEFAULT_FINAL_STEPS)
+        : _nRule(rule), _nRoundsPerBlock(roundsPerBlock), _nFinalSteps(finalSteps), _nBuffered(0) {
+        _ac.set_rule(static_cast<uint8_t>(rule));
+        reset();
+    }
+
+    void reset() {
+        // Vecteur initial : paramètres dans la capacité (octets 16..31)
+        uint8_t iv[HASH_SIZE_BYTES] = {0};
+        iv[AC_SPONGE_RATE_BYTES] = static_cast<uint8_t>(_nRule);
+        for (int i = 0; i < 4; ++i) {
+            iv[AC_SPONGE_RATE_BYTES + 1 + i] = static_cast<uint8_t>(_nRoundsPerBlock >> (8 * i));
+            iv[AC_SPONGE_RATE_BYTES + 5 + i] = static_cast<uint8_t>(_nFinalSteps >> (8 * i));
+        }
+        _ac.init_state(iv, HASH_SIZE_BYTES);
+        _nBuffered = 0;
+    }
+
+    AcHasher& update(const uint8_t* data, size_t length) {
+        if (_nBuffered != 0) {
+            size_t take = AC_SPONGE_RATE_BYTES - _nBuffered;
+            if (take > length) {
+                take = length;
+            }
+            std::memcpy(_buffer + _nBuffered, data, take);
+            _nBuffered += take;
+            data += take;
+            length -= take;
+            if (_nBuffered < AC_SPONGE_RATE_BYTES) {
+                return *this;
+            }
+            _AbsorbBlock(_buffer);
+            _nBuffered = 0;
+        }
+        for (; length >= AC_SPONGE_RATE_BYTES; data += AC_SPONGE_RATE_BYTES, length -= AC_SPONGE_RATE_BYTES) {
+            _AbsorbBlock(data);
+        }
+        std::memcpy(_buffer, data, length);
+        _nBuffered = length;
+        return *this;
+    }
+
+    AcHasher& update(const std::string& data) {
+        return update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    }
+
+    /**
+     * @brief Écrit les 32 octets du hash puis remet l'objet à zéro (reset()) :
+     * il peut hacher une nouvelle entrée directement.
+     */
+    void finalize(uint8_t* out) {
+        // Bourrage 10*1 : 0x80 après les données, 0x01 sur le dernier octet du bloc
+        std::memset(_buffer + _nBuffered, 0, AC_SPONGE_RATE_BYTES - _nBuffered);
+        _buffer[_nBuffered] ^= 0x80;
+        _buffer[AC_SPONGE_RATE_BYTES - 1] ^= 0x01;
+        _ac.absorb(_buffer, AC_SPONGE_RATE_BYTES);
+        _Evolve(_nFinalSteps);
+
+        for (size_t offset = 0; offset < HASH_SIZE_BYTES; offset += AC_SPONGE_RATE_BYTES) {
+            if (offset != 0) {
+                _Evolve(_nRoundsPerBlock);
+            }
+            std::memcpy(out + offset, _ac.get_final_state(), AC_SPONGE_RATE_BYTES);
+        }
+        reset();
+    }
+
+    std::array<uint8_t, HASH_SIZE_BYTES> finalize() {
+        std::array<uint8_t, HASH_SIZE_BYTES> digest;
+        finalize(digest.data());
+        return digest;
+    }
+};
+
+/**
+ * @brief Hash éponge d'un buffer complet (règles 30, 90, 110 : noyau dédié).
+ */
+inline std::array<uint8_t, HASH_SIZE_BYTES> ac_sponge_hash(const uint8_t* data, size_t length, uint32_t rule,
+                                                           size_t roundsPerBlock = AC_SPONGE_DEFAULT_ROUNDS) {
+    switch (rule) {
+        case 30:  return AcHasher<30>(rule, roundsPerBlock).update(data, length).finalize();
+        case 90:  return AcHasher<90>(rule, roundsPerBlock).update(data, length).finalize();
+        case 110: return AcHasher<110>(rule, roundsPerBlock).update(data, length).finalize();
+        default:  return AcHasher<>(rule, roundsPerBlock).update(data, length).finalize();
+    }
+}
+
+#endif // AC_SPONGE_HPP
@@ -0,0 +1,225 @@
+#ifndef AVALANCHE_HPP
+#define AVALANCHE_HPP
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "ac_hash.hpp"
+#include "ac_hash_batch.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * Analyse d'avalanche de ac_hash sur M messages aléatoires (généralise q5.cpp).
+ *
+ * Pour chaque message, chacun des 256 bits d'entrée est inversé ; on mesure
+ * la distance de Hamming entre les deux hashes (popcount 64 bits sur les
+ * hashes bruts) et on remplit la matrice du critère d'avalanche strict
+ * (SAC) : case (i, j) = nombre de fois où inverser le bit d'entrée i a
+ * inversé le bit de sortie j. Idéalement chaque case vaut M/2.
+ *
+ * Les messages font 32 octets : string_to_bytes est un XOR, donc inverser
+ * le bit i du message inverse exactement le bit i de l'état initial. Les
+ * 257 états (base + 256 variantes) sont évolués ensemble par ac_evolve_batch.
+ * Un bit au-delà du 256e retomberait sur le bit (i mod 256) : ces 256 bits
+ * couvrent toute l'entrée de l'automate.
+ *
+ * Le message m est tiré d'un générateur initialisé par (seed, m) et chaque
+ * thread accumule ses propres compteurs : le rapport ne dépend pas du nombre
+ * de threads.
+ */
+
+const size_t AVALANCHE_INPUT_BITS = HASH_SIZE_BITS;
+const size_t AVALANCHE_OUTPUT_BITS = HASH_SIZE_BITS;
+const size_t AVALANCHE_CHUNK_MESSAGES = 16;
+
+struct AvalancheConfig {
+    uint32_t rule;
+    size_t steps;
+    uint64_t messages;
+    uint64_t seed;
+};
+
+struct AvalancheReport {
+    AvalancheConfig config;
+    uint64_t flips;                        // messages * 256
+    double meanDistance;                   // idéal : 128
+    uint32_t minDistance;
+    uint32_t maxDistance;
+    std::vector<uint64_t> distanceHistogram; // [0, 256]
+    std::vector<uint64_t> sacCounts;         // [entrée * 256 + sortie]
+    double maxSacBias;                     // max |P(inversion) - 1/2|
+    double meanSacBias;
+    uint64_t deadPairs;                    // cases jamais (ou toujours) inversées
+    double seconds;
+
+    double SacProbability(size_t inputBit, size_t outputBit) const {
+        return static_cast<double>(sacCounts[inputBit * AVALANCHE_OUTPUT_BITS + outputBit]) / config.messages;
+    }
+
+    // Écart-type de P(inversion) pour un hash idéal : 0.5 / sqrt(M)
+    double SacSigma() const {
+        return 0.5 / std::sqrt(static_cast<double>(config.messages));
+    }
+
+    /**
+     * @brief Le SAC est respecté si aucune case ne s'écarte de 1/2 de plus de
+     * 'nSigmas' écarts-types (6 : ~1e-9 de faux positif par case).
+     */
+    bool MeetsSac(double nSigmas = 6.0) const {
+        return deadPairs == 0 && maxSacBias <= nSigmas * SacSigma();
+    }
+};
+
+inline uint32_t avalanche_hamming_distance(const uint8_t* a, const uint8_t* b, size_t size) {
+    uint32_t distance = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, a + i, 8);
+        std::memcpy(&y, b + i, 8);
+        distance += static_cast<uint32_t>(__builtin_popcountll(x ^ y));
+    }
+    for (; i < size; ++i) {
+        distance += static_cast<uint32_t>(__builtin_popcount(a[i] ^ b[i]));
+    }
+    return distance;
+}
+
+// Générateur SplitMix64 : message m reproductible, indépendant de l'ordre de calcul
+inline uint64_t avalanche_mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+inline void avalanche_message(uint64_t seed, uint64_t index, uint8_t* message) {
+    uint64_t state = avalanche_mix64(seed) ^ index;
+    for (size_t i = 0; i < HASH_SIZE_BYTES; i += 8) {
+        uint64_t word = avalanche_mix64(state + i);
+        std::memcpy(message + i, &word, 8);
+    }
+}
+
+class AvalancheAnalyzer {
+private:
+    ThreadPool& _pool;
+
+    struct ThreadAccumulator {
+        std::vector<uint64_t> sac;
+        std::vector<uint64_t> histogram;
+    };
+
+    // Accumule les inversions d'un message dans 'acc'
+    static void _AnalyzeMessage(const AvalancheConfig& config, uint64_t index, ThreadAccumulator& acc,
+                                uint8_t (*states)[HASH_SIZE_BYTES], uint8_t (*digests)[HASH_SIZE_BYTES]) {
+        uint8_t message[HASH_SIZE_BYTES];
+        avalanche_message(config.seed, index, message);
+        string_to_bytes(message, sizeof(message), states[0], HASH_SIZE_BYTES);
+        for (size_t bit = 0; bit < AVALANCHE_INPUT_BITS; ++bit) {
+            std::memcpy(states[bit + 1], states[0], HASH_SIZE_BYTES);
+            states[bit + 1][bit / 8] ^= static_cast<uint8_t>(0x80 >> (bit % 8));
+        }
+        ac_evolve_batch(states, AVALANCHE_INPUT_BITS + 1, config.rule, config.steps, digests);
+
+        for (size_t bit = 0; bit < AVALANCHE_INPUT_BITS; ++bit) {
+            uint64_t* row = acc.sac.data() + bit * AVALANCHE_OUTPUT_BITS;
+            uint32_t distance = 0;
+            for (size_t w = 0; w < HASH_SIZE_BYTES / 8; ++w) {
+                uint64_t x, y;
+                std::memcpy(&x, digests[0] + 8 * w, 8);
+                std::memcpy(&y, digests[bit + 1] + 8 * w, 8);
+                uint64_t diff = x ^ y;
+                distance += static_cast<uint32_t>(__builtin_popcountll(diff));
+                while (diff != 0) {
+                    // Bit b du mot chargé = octet b/8, bit (b%8) depuis le poids faible
+                    unsigned b = static_cast<unsigned>(__builtin_ctzll(diff));
+                    ++row[64 * w + (b & ~7u) + 7 - (b & 7u)];
+                    diff &= diff - 1;
+                }
+            }
+            ++acc.histogram[distance];
+        }
+    }
+
+public:
+    explicit AvalancheAnalyzer(ThreadPool& pool) : _pool(pool) {}
+
+    AvalancheReport Run(const AvalancheConfig& config) {
+        if (config.messages == 0) {
+            throw std::invalid_argument("AvalancheAnalyzer: aucun message.");
+        }
+        auto t_start = std::chrono::steady_clock::now();
+
+        std::vector<ThreadAccumulator> accumulators(_pool.Size());
+        std::atomic<uint64_t> next(0);
+        _pool.RunOnAll([&](unsigned t) {
+            ThreadAccumulator& acc = accumulators[t];
+            acc.sac.assign(AVALANCHE_INPUT_BITS * AVALANCHE_OUTPUT_BITS, 0);
+            acc.histogram.assign(AVALANCHE_OUTPUT_BITS + 1, 0);
+            std::vector<uint8_t> buffers(2 * (AVALANCHE_INPUT_BITS + 1) * HASH_SIZE_BYTES);
+            uint8_t (*states)[HASH_SIZE_BYTES] = reinterpret_cast<uint8_t (*)[HASH_SIZE_BYTES]>(buffers.data());
+            uint8_t (*digests)[HASH_SIZE_BYTES] = states + AVALANCHE_INPUT_BITS + 1;
+
+            for (;;) {
+                uint64_t begin = next.fetch_add(AVALANCHE_CHUNK_MESSAGES, std::memory_order_relaxed);
+                if (begin >= config.messages) {
+                    return;
+                }
+                uint64_t end = std::min<uint64_t>(begin + AVALANCHE_CHUNK_MESSAGES, config.messages);
+                for (uint64_t m = begin; m < end; ++m) {
+                    _AnalyzeMessage(config, m, acc, states, digests);
+                }
+            }
+        });
+
+        AvalancheReport report;
+        report.config = config;
+        report.flips = config.messages * AVALANCHE_INPUT_BITS;
+        report.sacCounts.assign(AVALANCHE_INPUT_BITS * AVALANCHE_OUTPUT_BITS, 0);
+        report.distanceHistogram.assign(AVALANCHE_OUTPUT_BITS + 1, 0);
+        for (const ThreadAccumulator& acc : accumulators) {
+            for (size_t i = 0; i < report.sacCounts.size(); ++i) {
+                report.sacCounts[i] += acc.sac[i];
+            }
+            for (size_t d = 0; d < report.distanceHistogram.size(); ++d) {
+                report.distanceHistogram[d] += acc.histogram[d];
+            }
+        }
+
+        double distanceSum = 0.0;
+        report.minDistance = static_cast<uint32_t>(AVALANCHE_OUTPUT_BITS);
+        report.maxDistance = 0;
+        for (size_t d = 0; d < report.distanceHistogram.size(); ++d) {
+            if (report.distanceHistogram[d] != 0) {
+                distanceSum += static_cast<double>(d) * report.distanceHistogram[d];
+                report.minDistance = std::min(report.minDistance, static_cast<uint32_t>(d));
+                report.maxDistance = static_cast<uint32_t>(d);
+            }
+        }
+        report.meanDistance = distanceSum / report.flips;
+
+        report.maxSacBias = 0.0;
+        report.deadPairs = 0;
+        double biasSum = 0.0;
+        for (uint64_t count : report.sacCounts) {
+            double bias = std::fabs(static_cast<double>(count) / config.messages - 0.5);
+            report.maxSacBias = std::max(report.maxSacBias, bias);
+            biasSum += bias;
+            if (count == 0 || count == config.messages) {
+                ++report.deadPairs;
+            }
+        }
+        report.meanSacBias = biasSum / report.sacCounts.size();
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+        return report;
+    }
+};
+
+#endif // AVALANCHE_HPP
@@ -0,0 +1,285 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstring>
+
+#include "sha256.hpp"
+#include "ac_hash.hpp"
+#include "ac_hash_batch.hpp"
+#include "ac_sponge.hpp"
+#include "ac_hash_lut.hpp"
+#include "block_hash.hpp"
+#include "block_header.hpp"
+#include "validator_registry.hpp"
+#include "bench.hpp"
+
+/**
+ * Suite de benchmarks : ac_hash (règle x étapes), sha256 (taille du message),
+ * minage (méthode x difficulté) et sélection PoS (nombre de validateurs).
+ *
+ * Usage : bench [--quick] [--suite ac_hash|sha256|mine|pos] [--json fichier] [--csv fichier]
+ */
+
+static std::string param(const std::string& key, uint64_t value) {
+    return key + "=" + std::to_string(value);
+}
+
+template <size_t WidthBits>
+void bench_ac_width(BenchRunner& runner, const uint8_t (&input)[HASH_SIZE_BYTES]) {
+    uint8_t out[WidthBits / 8];
+    for (size_t steps : {size_t(128), WidthBits / 2}) {
+        runner.Run("ac_hash", "largeur", param("largeur", WidthBits) + "," + param("etapes", steps), "hash", [&] {
+            ac_hash_bytes_width<WidthBits>(input, sizeof(input), 30, steps, out);
+            bench_do_not_optimize(out);
+            return 1;
+        });
+    }
+}
+
+void bench_ac_hash(BenchRunner& runner) {
+    uint8_t input[HASH_SIZE_BYTES];
+    for (size_t i = 0; i < sizeof(input); ++i) {
+        input[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    uint8_t out[HASH_SIZE_BYTES];
+
+    // 30, 90 et 110 ont un noyau dédié ; 45 passe par le noyau générique (ANF)
+    for (uint32_t rule : {30u, 90u, 110u, 45u}) {
+        for (size_t steps : {64u, 128u, 256u}) {
+            runner.Run("ac_hash", "ac_hash_bytes", param("regle", rule) + "," + param("etapes", steps), "hash",
+                       [&] {
+                           ac_hash_bytes(input, sizeof(input), rule, steps, out);
+                           bench_do_not_optimize(out);
+                           input[0] ^= out[0]; // chaque appel dépend du précédent
+                           return 1;
+                       });
+        }
+    }
+
+    // Moteurs d'évolution (ac_hash_lut.hpp) : bitslice générique, dédié, tables
+    for (uint32_t rule : {30u, 45u}) {
+        for (AcEngine engine : {AcEngine::BITSLICE_ANF, AcEngine::BITSLICE_RULE, AcEngine::LUT}) {
+            if (!ac_engine_supported(engine, rule)) {
+                continue;
+            }
+            runner.Run("ac_hash", std::string("moteur_") + ac_engine_name(engine),
+                       param("regle", rule) + "," + param("etapes", 128), "hash", [&] {
+                           ac_hash_bytes_engine(engine, input, sizeof(input), rule, 128, out);
+                           bench_do_not_optimize(out);
+                           input[0] ^= out[0];
+                           return 1;
+                       });
+        }
+    }
+
+    // Largeur de l'automate : 128 générations fixes contre largeur / 2
+    bench_ac_width<128>(runner, input);
+    bench_ac_width<512>(runner, input);
+    bench_ac_width<1024>(runner, input);
+
+    const size_t nBatch = 256;
+    std::vector<std::string> inputs(nBatch);
+    for (size_t i = 0; i < nBatch; ++i) {
+        inputs[i] = "message_test_" + std::to_string(i);
+    }
+    std::vector<uint8_t> digests(nBatch * HASH_SIZE_BYTES);
+    uint8_t (*outs)[HASH_SIZE_BYTES] = reinterpret_cast<uint8_t (*)[HASH_SIZE_BYTES]>(digests.data());
+    for (uint32_t rule : {30u, 90u, 110u}) {
+        runner.Run("ac_hash", std::string("batch_") + ac_batch_backend_name(ac_batch_best_backend()),
+                   param("regle", rule) + "," + param("etapes", 128), "hash", [&] {
+                       ac_hash_batch(inputs.data(), nBatch, rule, 128, outs);
+                       bench_do_not_optimize(digests.data()[0]);
+                       return nBatch;
+                   });
+    }
+
+    // Entrées longues : repliement + 128 générations contre éponge (AcHasher)
+    std::vector<uint8_t> message(65536);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+    for (size_t size : {1024u, 65536u}) {
+        runner.Run("ac_hash", "repliement", param("regle", 30) + "," + param("octets", size), "octet", [&] {
+            ac_hash_bytes(message.data(), size, 30, 128, out);
+            bench_do_not_optimize(out);
+            return size;
+        });
+        runner.Run("ac_hash", "eponge", param("regle", 30) + "," + param("octets", size), "octet", [&] {
+            std::array<uint8_t, HASH_SIZE_BYTES> digest = ac_sponge_hash(message.data(), size, 30);
+            bench_do_not_optimize(digest);
+            return size;
+        });
+    }
+}
+
+void bench_sha256(BenchRunner& runner) {
+    std::vector<uint8_t> message(16384);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+    const std::string backend = sha256_backend_name(sha256_active_backend());
+
+    for (size_t size : {32u, 64u, 256u, 1024u, 16384u}) {
+        runner.Run("sha256", "sha256_raw_" + backend, param("octets", size), "octet", [&] {
+            Hash256 digest = sha256_raw(message.data(), size);
+            bench_do_not_optimize(digest);
+            message[0] ^= digest[0];
+            return size;
+        });
+    }
+
+    const size_t nBatch = 256;
+    std::vector<std::string> inputs(nBatch, std::string(64, 'a'));
+    std::vector<uint8_t> digests(nBatch * 32);
+    uint8_t (*outs)[32] = reinterpret_cast<uint8_t (*)[32]>(digests.data());
+    for (Sha256Backend b : {Sha256Backend::SCALAR, Sha256Backend::SHANI, Sha256Backend::AVX2_X8}) {
+        if (!sha256_backend_supported(b)) {
+            continue;
+        }
+        runner.Run("sha256", std::string("batch_") + sha256_backend_name(b), param("octets", 64), "octet", [&] {
+            sha256_batch(inputs.data(), nBatch, outs, b);
+            bench_do_not_optimize(digests.data()[0]);
+            return nBatch * 64;
+        });
+    }
+}
+
+/**
+ * Minage d'un bloc : un appel = un nouvel en-tête miné jusqu'à la difficulté.
+ * L'unité est le hash : la médiane par appel dépend de la chance, le débit
+ * en hashes/s et les cycles/hash non.
+ */
+void bench_mine(BenchRunner& runner, bool bQuick) {
+    struct Case {
+        HashMethod method;
+        uint32_t maxDifficulty;
+    };
+    const Case cases[] = {{HashMethod::SHA256, bQuick ? 3u : 4u}, {HashMethod::AC_HASH, bQuick ? 2u : 3u}};
+
+    for (const Case& c : cases) {
+        for (uint32_t difficulty = 1; difficulty <= c.maxDifficulty; ++difficulty) {
+            BlockHeader header{0, 1700000000, Hash256(), sha256_raw(std::string("bench")), 0, 0, 0};
+            runner.Run("mine", std::string("header_") + hash_method_name(c.method), param("difficulte", difficulty),
+                       "hash", [&] {
+                           ++header.index;
+                           HeaderNonceHasher hasher(c.method, header);
+                           Hash256 hash;
+                           int64_t nonce = 0;
+                           do {
+                               hasher(++nonce, hash);
+                           } while (!hash_meets_difficulty(hash, difficulty));
+                           return static_cast<uint64_t>(nonce);
+                       });
+        }
+    }
+
+    // Préimage texte (legacy) : SHA256 uniquement
+    for (uint32_t difficulty = 1; difficulty <= (bQuick ? 3u : 4u); ++difficulty) {
+        uint32_t index = 0;
+        runner.Run("mine", "legacy_SHA256", param("difficulte", difficulty), "hash", [&] {
+            NonceHasher hasher(HashMethod::SHA256, std::to_string(++index) + "1700000000bench" + std::string(64, '0'));
+            Hash256 hash;
+            int64_t nonce = 0;
+            do {
+                hasher(++nonce, hash);
+            } while (!hash_meets_difficulty(hash, difficulty));
+            return static_cast<uint64_t>(nonce);
+        });
+    }
+}
+
+void bench_pos(BenchRunner& runner) {
+    for (size_t count : {10u, 1000u, 100000u}) {
+        ValidatorRegistry registry(42);
+        std::vector<Validator> validators;
+        std::mt19937_64 rng(7);
+        for (size_t i = 0; i < count; ++i) {
+            double stake = 1.0 + static_cast<double>(rng() % 1000);
+            registry.Add("validateur_" + std::to_string(i), stake);
+            validators.push_back({"validateur_" + std::to_string(i), stake});
+        }
+
+        // Référence : parcours linéaire de l'ancienne SelectValidator (générateur réutilisé)
+        runner.Run("pos", "lineaire", param("validateurs", count), "tirage", [&] {
+            double totalStake = 0.0;
+            for (const auto& v : validators) { totalStake += v.stake; }
+            double randomPoint = std::uniform_real_distribution<>(0, totalStake)(rng);
+            double currentSum = 0.0;
+            size_t chosen = validators.size() - 1;
+            for (size_t i = 0; i < validators.size(); ++i) {
+                currentSum += validators[i].stake;
+                if (randomPoint <= currentSum) { chosen = i; break; }
+            }
+            bench_do_not_optimize(chosen);
+            return 1;
+        });
+
+        registry.SetSamplingMode(ValidatorRegistry::SamplingMode::FENWICK);
+        runner.Run("pos", "fenwick", param("validateurs", count), "tirage", [&] {
+            size_t chosen = registry.SelectIndex();
+            bench_do_not_optimize(chosen);
+            return 1;
+        });
+
+        registry.SetSamplingMode(ValidatorRegistry::SamplingMode::ALIAS);
+        runner.Run("pos", "alias", param("validateurs", count), "tirage", [&] {
+            size_t chosen = registry.SelectIndex();
+            bench_do_not_optimize(chosen);
+            return 1;
+        });
+    }
+}
+
+
+int main(int argc, char** argv) {
+    bool bQuick = false;
+    std::string suite;
+    std::string jsonPath;
+    std::string csvPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            bQuick = true;
+        } else if (arg == "--suite" && i + 1 < argc) {
+            suite = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else {
+            std::cerr << "Usage : " << argv[0]
+                      << " [--quick] [--suite ac_hash|sha256|mine|pos] [--json fichier] [--csv fichier]" << std::endl;
+            return 1;
+        }
+    }
+
+    BenchRunner runner(bQuick ? BENCH_QUICK_CONFIG : BENCH_DEFAULT_CONFIG);
+    std::cout << "--- BENCHMARKS (" << (bQuick ? "rapide" : "complet") << ") ---" << std::endl;
+    if (suite.empty() || suite == "ac_hash") {
+        bench_ac_hash(runner);
+    }
+    if (suite.empty() || suite == "sha256") {
+        bench_sha256(runner);
+    }
+    if (suite.empty() || suite == "mine") {
+        bench_mine(runner, bQuick);
+    }
+    if (suite.empty() || suite == "pos") {
+        bench_pos(runner);
+    }
+    runner.PrintTable(std::cout);
+
+    if (!jsonPath.empty()) {
+        std::ofstream json(jsonPath);
+        runner.WriteJson(json);
+        std::cout << "Resultats JSON : " << jsonPath << std::endl;
+    }
+    if (!csvPath.empty()) {
+        std::ofstream csv(csvPath);
+        runner.WriteCsv(csv);
+        std::cout << "Resultats CSV : " << csvPath << std::endl;
+    }
+    return 0;
+}
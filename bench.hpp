@@ -0,0 +1,213 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <ostream>
+#include <iomanip>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Harnais de mesure commun (bench.cpp, q7.cpp).
+ *
+ * Chaque mesure : quelques itérations de chauffe, puis N échantillons. Le
+ * nombre d'appels par échantillon est calibré pour qu'un échantillon dure au
+ * moins 'minSampleSeconds' (la résolution de l'horloge devient négligeable).
+ * La fonction mesurée retourne le nombre d'unités de travail effectuées
+ * (hashes, octets...) : on en déduit unités/s et cycles/unité.
+ * Les résultats s'exportent en JSON ou en CSV pour suivre les régressions
+ * entre deux versions de ac_hash.hpp / sha256.hpp.
+ */
+
+struct BenchConfig {
+    size_t warmupCalls;
+    size_t samples;
+    double minSampleSeconds;
+};
+
+// Mesure complète (défaut) et mesure rapide (--quick)
+const BenchConfig BENCH_DEFAULT_CONFIG = {3, 31, 0.02};
+const BenchConfig BENCH_QUICK_CONFIG = {1, 11, 0.002};
+
+struct BenchResult {
+    std::string suite;
+    std::string name;
+    std::string params;   // "regle=30,etapes=128"...
+    std::string unit;     // unité de travail : "hash", "octet", "tirage"...
+    size_t samples;
+    uint64_t callsPerSample;
+    double medianNsPerCall;
+    double p99NsPerCall;
+    double minNsPerCall;
+    double unitsPerSecond; // sur l'échantillon médian
+    double cyclesPerUnit;  // cycles TSC (0 si indisponible)
+};
+
+// Empêche le compilateur de supprimer un calcul dont le résultat n'est pas utilisé
+template <class T>
+inline void bench_do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Compteur de cycles de référence (TSC) ; 0 hors x86
+inline uint64_t bench_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+class BenchRunner {
+private:
+    BenchConfig _config;
+    std::vector<BenchResult> _vResults;
+
+    static std::string _JsonEscape(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out.push_back('\\');
+            }
+            out.push_back(c);
+        }
+        return out;
+    }
+
+public:
+    explicit BenchRunner(const BenchConfig& config = BENCH_DEFAULT_CONFIG) : _config(config) {}
+
+    const std::vector<BenchResult>& Results() const {
+        return _vResults;
+    }
+
+    /**
+     * @brief Mesure fn() ; fn retourne le nombre d'unités de travail de l'appel.
+     */
+    template <class Fn>
+    const BenchResult& Run(const std::string& suite, const std::string& name, const std::string& params,
+                           const std::string& unit, Fn fn) {
+        typedef std::chrono::steady_clock Clock;
+
+        for (size_t i = 0; i < _config.warmupCalls; ++i) {
+            fn();
+        }
+
+        // Calibration : on double le nombre d'appels jusqu'à la durée minimale
+        uint64_t calls = 1;
+        for (;;) {
+            auto t0 = Clock::now();
+            for (uint64_t i = 0; i < calls; ++i) {
+                fn();
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+            if (seconds >= _config.minSampleSeconds || calls >= (uint64_t(1) << 40)) {
+                break;
+            }
+            calls *= 2;
+        }
+
+        struct Sample {
+            double nsPerCall;
+            double unitsPerSecond;
+            double cyclesPerUnit;
+        };
+        std::vector<Sample> samples(_config.samples);
+        for (Sample& sample : samples) {
+            uint64_t units = 0;
+            uint64_t c0 = bench_cycles();
+            auto t0 = Clock::now();
+            for (uint64_t i = 0; i < calls; ++i) {
+                units += fn();
+            }
+            auto t1 = Clock::now();
+            uint64_t c1 = bench_cycles();
+            double seconds = std::chrono::duration<double>(t1 - t0).count();
+            sample.nsPerCall = seconds * 1e9 / calls;
+            sample.unitsPerSecond = seconds > 0.0 ? units / seconds : 0.0;
+            sample.cyclesPerUnit = units > 0 ? static_cast<double>(c1 - c0) / units : 0.0;
+        }
+
+        std::sort(samples.begin(), samples.end(),
+                  [](const Sample& a, const Sample& b) { return a.nsPerCall < b.nsPerCall; });
+        const Sample& median = samples[samples.size() / 2];
+        size_t p99Rank = (samples.size() * 99 + 99) / 100; // rang le plus proche, 1-indexé
+
+        BenchResult result;
+        result.suite = suite;
+        result.name = name;
+        result.params = params;
+        result.unit = unit;
+        result.samples = samples.size();
+        result.callsPerSample = calls;
+        result.medianNsPerCall = median.nsPerCall;
+        result.p99NsPerCall = samples[std::min(p99Rank, samples.size()) - 1].nsPerCall;
+        result.minNsPerCall = samples.front().nsPerCall;
+        result.unitsPerSecond = median.unitsPerSecond;
+        result.cyclesPerUnit = median.cyclesPerUnit;
+        _vResults.push_back(result);
+        return _vResults.back();
+    }
+
+    void PrintTable(std::ostream& os) const {
+        os << std::left << std::setw(10) << "suite" << std::setw(22) << "mesure" << std::setw(26) << "parametres"
+           << std::right << std::setw(14) << "median ns" << std::setw(14) << "p99 ns"
+           << std::setw(16) << "unites/s" << std::setw(12) << "cycles/u" << std::endl;
+        for (const BenchResult& r : _vResults) {
+            PrintRow(os, r);
+        }
+    }
+
+    static void PrintRow(std::ostream& os, const BenchResult& r) {
+        std::ios::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+        os << std::left << std::setw(10) << r.suite << std::setw(22) << r.name << std::setw(26) << r.params
+           << std::right << std::fixed << std::setprecision(1)
+           << std::setw(14) << r.medianNsPerCall << std::setw(14) << r.p99NsPerCall
+           << std::setprecision(0) << std::setw(16) << r.unitsPerSecond
+           << std::setprecision(1) << std::setw(12) << r.cyclesPerUnit << " (" << r.unit << ")" << std::endl;
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+    void WriteCsv(std::ostream& os) const {
+        os << "suite,name,params,unit,samples,calls_per_sample,median_ns_per_call,p99_ns_per_call,"
+              "min_ns_per_call,units_per_second,cycles_per_unit\n";
+        std::ios::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+        os << std::setprecision(6);
+        for (const BenchResult& r : _vResults) {
+            os << r.suite << ',' << r.name << ",\"" << r.params << "\"," << r.unit << ',' << r.samples << ','
+               << r.callsPerSample << ',' << r.medianNsPerCall << ',' << r.p99NsPerCall << ','
+               << r.minNsPerCall << ',' << r.unitsPerSecond << ',' << r.cyclesPerUnit << '\n';
+        }
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+    void WriteJson(std::ostream& os) const {
+        std::ios::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+        os << std::setprecision(6) << "[\n";
+        for (size_t i = 0; i < _vResults.size(); ++i) {
+            const BenchResult& r = _vResults[i];
+            os << "  {\"suite\": \"" << _JsonEscape(r.suite) << "\", \"name\": \"" << _JsonEscape(r.name)
+               << "\", \"params\": \"" << _JsonEscape(r.params) << "\", \"unit\": \"" << _JsonEscape(r.unit)
+               << "\", \"samples\": " << r.samples << ", \"calls_per_sample\": " << r.callsPerSample
+               << ", \"median_ns_per_call\": " << r.medianNsPerCall << ", \"p99_ns_per_call\": " << r.p99NsPerCall
+               << ", \"min_ns_per_call\": " << r.minNsPerCall << ", \"units_per_second\": " << r.unitsPerSecond
+               << ", \"cycles_per_unit\": " << r.cyclesPerUnit << "}" << (i + 1 < _vResults.size() ? "," : "") << "\n";
+        }
+        os << "]\n";
+        os.flags(flags);
+        os.precision(precision);
+    }
+};
+
+#endif // BENCH_HPP
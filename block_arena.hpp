@@ -0,0 +1,120 @@
+#ifndef BLOCK_ARENA_HPP
+#define BLOCK_ARENA_HPP
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * Stockage appartenant à la chaîne pour les données des blocs (simpleblockchain.cpp).
+ *
+ * - PayloadArena : les données sont copiées bout à bout dans des tranches de
+ *   taille fixe qui ne sont jamais déplacées ni libérées avant l'arène. Un
+ *   Block ne garde qu'une std::string_view : une allocation par tranche
+ *   (64 Kio par défaut) au lieu d'une par bloc. Une donnée plus grande qu'une
+ *   tranche reçoit sa propre tranche.
+ * - StringPool : chaque chaîne distincte (adresse de validateur) est stockée
+ *   une seule fois et désignée par un identifiant 32 bits.
+ * Les vues retournées restent valides tant que l'arène (ou le pool) existe.
+ */
+
+const size_t ARENA_DEFAULT_CHUNK_BYTES = 64 * 1024;
+
+class PayloadArena {
+private:
+    size_t _nChunkBytes;
+    std::vector<std::unique_ptr<char[]>> _vChunks;
+    char* _pCurrent; // tranche en cours de remplissage (nullptr : aucune)
+    size_t _nUsed;   // octets utilisés dans _pCurrent
+    size_t _nBytes;
+
+public:
+    explicit PayloadArena(size_t nChunkBytes = ARENA_DEFAULT_CHUNK_BYTES)
+        : _nChunkBytes(nChunkBytes), _pCurrent(nullptr), _nUsed(0), _nBytes(0) {
+        if (_nChunkBytes == 0) {
+            throw std::invalid_argument("PayloadArena: la taille de tranche doit etre non nulle.");
+        }
+    }
+
+    PayloadArena(const PayloadArena&) = delete;
+    PayloadArena& operator=(const PayloadArena&) = delete;
+
+    /**
+     * @brief Copie 'data' dans l'arène et retourne la vue sur la copie.
+     */
+    std::string_view Store(std::string_view data) {
+        if (data.empty()) {
+            return std::string_view();
+        }
+        if (data.size() > _nChunkBytes) {
+            // Tranche dédiée : la tranche courante reste ouverte
+            _vChunks.emplace_back(new char[data.size()]);
+            std::memcpy(_vChunks.back().get(), data.data(), data.size());
+            _nBytes += data.size();
+            return std::string_view(_vChunks.back().get(), data.size());
+        }
+        if (_pCurrent == nullptr || _nChunkBytes - _nUsed < data.size()) {
+            _vChunks.emplace_back(new char[_nChunkBytes]);
+            _pCurrent = _vChunks.back().get();
+            _nUsed = 0;
+        }
+        char* p = _pCurrent + _nUsed;
+        std::memcpy(p, data.data(), data.size());
+        _nUsed += data.size();
+        _nBytes += data.size();
+        return std::string_view(p, data.size());
+    }
+
+    size_t Bytes() const {
+        return _nBytes;
+    }
+
+    size_t ChunkCount() const {
+        return _vChunks.size();
+    }
+};
+
+class StringPool {
+private:
+    PayloadArena _arena;
+    std::vector<std::string_view> _vStrings;
+    std::unordered_map<std::string_view, uint32_t> _ids; // clés : vues dans _arena
+
+public:
+    explicit StringPool(size_t nChunkBytes = 4096) : _arena(nChunkBytes) {}
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /**
+     * @brief Identifiant de 's', attribué au premier appel (0, 1, 2...).
+     */
+    uint32_t Intern(std::string_view s) {
+        auto it = _ids.find(s);
+        if (it != _ids.end()) {
+            return it->second;
+        }
+        uint32_t id = static_cast<uint32_t>(_vStrings.size());
+        std::string_view stored = _arena.Store(s);
+        _vStrings.push_back(stored);
+        _ids.emplace(stored, id);
+        return id;
+    }
+
+    std::string_view Get(uint32_t id) const {
+        if (id >= _vStrings.size()) {
+            throw std::out_of_range("StringPool: identifiant inconnu.");
+        }
+        return _vStrings[id];
+    }
+
+    size_t Size() const {
+        return _vStrings.size();
+    }
+};
+
+#endif // BLOCK_ARENA_HPP
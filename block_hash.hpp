@@ -0,0 +1,145 @@
+#ifndef BLOCK_HASH_HPP
+#define BLOCK_HASH_HPP
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+
+#include "sha256.hpp"
+#include "ac_hash.hpp"
+
+/**
+ * Outils de hachage communs aux classes Block (q3.cpp, q4.cpp, simpleblockchain.cpp).
+ *
+ * Les hashes des blocs sont gardes en binaire (32 octets) : la comparaison a la
+ * difficulte et le chainage se font sur les octets, et l'hexadecimal n'est
+ * produit que pour l'affichage.
+ */
+
+typedef std::array<uint8_t, 32> Hash256;
+
+/**
+ * 3.1. Option de sélection du mode de hachage
+ */
+enum class HashMethod {
+    SHA256,
+    AC_HASH
+};
+
+// Paramètres d'AC_HASH utilisés pour les blocs (Q3)
+const uint32_t BLOCK_AC_RULE = 30;
+const size_t BLOCK_AC_STEPS = 128;
+
+inline const char* hash_method_name(HashMethod method) {
+    return method == HashMethod::AC_HASH ? "AC_HASH" : "SHA256";
+}
+
+/**
+ * @brief Hash binaire d'un buffer avec la méthode choisie (aucune allocation).
+ */
+inline Hash256 compute_hash_raw(HashMethod method, const uint8_t* data, size_t length) {
+    switch (method) {
+        case HashMethod::AC_HASH:
+            return ac_hash_raw(data, length, BLOCK_AC_RULE, BLOCK_AC_STEPS);
+        case HashMethod::SHA256:
+        default:
+            return sha256_raw(data, length);
+    }
+}
+
+inline Hash256 compute_hash_raw(HashMethod method, const std::string& data) {
+    return compute_hash_raw(method, reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+/**
+ * @brief Équivalent binaire de sHash.compare(0, nDifficulty, "000...") == 0 :
+ * les 'nDifficulty' premiers chiffres hexadécimaux (quartets) doivent être nuls.
+ */
+inline bool hash_meets_difficulty(const Hash256& hash, uint32_t nDifficulty) {
+    if (nDifficulty > hash.size() * 2) {
+        return false;
+    }
+    uint32_t full_bytes = nDifficulty / 2;
+    for (uint32_t i = 0; i < full_bytes; ++i) {
+        if (hash[i] != 0) {
+            return false;
+        }
+    }
+    // Difficulté impaire : le quartet de poids fort de l'octet suivant doit être nul.
+    return (nDifficulty & 1) == 0 || (hash[full_bytes] >> 4) == 0;
+}
+
+/**
+ * @brief Hexadécimal du hash, uniquement pour l'affichage et les préimages texte.
+ */
+inline std::string hash_to_hex(const Hash256& hash) {
+    return bytes_to_hex_string(hash.data(), hash.size());
+}
+
+/**
+ * @brief Hash précédent dans une préimage texte (legacy) : en hexadécimal,
+ * sauf pour le Genesis (index 0), sans prédécesseur, qui garde la chaîne vide
+ * de l'ancien sPrevHash jamais renseigné.
+ */
+inline std::string prev_hash_preimage(uint32_t nIndex, const Hash256& prevHash) {
+    return nIndex == 0 ? std::string() : hash_to_hex(prevHash);
+}
+
+// Même hexadécimal écrit dans out[0..63], sans allocation
+inline void hash_to_hex(const Hash256& hash, char* out) {
+    static const char hex_chars[] = "0123456789abcdef";
+    for (size_t i = 0; i < hash.size(); ++i) {
+        out[2 * i] = hex_chars[hash[i] >> 4];
+        out[2 * i + 1] = hex_chars[hash[i] & 0xF];
+    }
+}
+
+/**
+ * @class NonceHasher
+ * Hash "préimage + nonce" pour le minage. Aucune allocation par nonce.
+ * - SHA256 : la préimage constante est absorbée une seule fois dans un état
+ *   SHA256 sauvegardé (midstate : m_h, m_block, m_len). Pour chaque nonce on
+ *   copie cet état et on n'ajoute que les chiffres du nonce : le coût ne dépend
+ *   plus de la taille de _sData.
+ * - AC_HASH : la préimage est copiée une fois dans un buffer réservé et seuls
+ *   les chiffres du nonce sont réécrits (std::to_chars) à chaque essai.
+ * Chaque thread de minage possède son propre NonceHasher.
+ */
+class NonceHasher {
+private:
+    std::string _sBuffer;
+    size_t _nBaseLen;
+    HashMethod _hMethod;
+    SHA256 _shaMidstate;
+
+public:
+    NonceHasher(HashMethod method, const std::string& basePreimage)
+        : _nBaseLen(basePreimage.size()), _hMethod(method) {
+        if (_hMethod == HashMethod::SHA256) {
+            _shaMidstate.update(basePreimage);
+        } else {
+            _sBuffer.reserve(_nBaseLen + 20); // 20 chiffres suffisent pour un int64_t
+            _sBuffer = basePreimage;
+        }
+    }
+
+    void operator()(int64_t nonce, Hash256& out) {
+        char digits[20];
+        char* digits_end = std::to_chars(digits, digits + sizeof(digits), nonce).ptr;
+
+        if (_hMethod == HashMethod::SHA256) {
+            SHA256 sha = _shaMidstate; // copie du midstate (~100 octets, sur la pile)
+            sha.update(reinterpret_cast<const uint8_t*>(digits), digits_end - digits);
+            sha.digest(out.data());
+            return;
+        }
+
+        _sBuffer.resize(_nBaseLen);
+        _sBuffer.append(digits, digits_end);
+        out = compute_hash_raw(_hMethod, _sBuffer);
+    }
+};
+
+#endif // BLOCK_HASH_HPP
@@ -0,0 +1,137 @@
+#ifndef BLOCK_HEADER_HPP
+#define BLOCK_HEADER_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "block_hash.hpp"
+
+/**
+ * En-tête binaire de bloc à taille fixe (nouveau mode de hachage).
+ *
+ * La préimage "legacy" est une concaténation de std::to_string : sa taille
+ * change quand le nonce gagne un chiffre et le nonce est reformaté à chaque
+ * essai. Ici l'en-tête a toujours la même disposition (92 octets, entiers en
+ * little-endian) et le mineur réécrit les 8 octets du nonce sur place.
+ *
+ *   offset  taille  champ
+ *        0       4  index
+ *        4       8  timestamp
+ *       12      32  hash du bloc précédent
+ *       44      32  hash des données (racine de Merkle)
+ *       76       4  identifiant du validateur (0 en PoW)
+ *       80       4  cible compacte "bits" (0 : difficulté en zéros hexadécimaux)
+ *       84       8  nonce
+ */
+
+enum class BlockFormat {
+    LEGACY_STRING, // to_string(index) + to_string(time) + data + hex(prevHash) [+ hex(bits)] + nonce
+    BINARY_HEADER  // BlockHeader sérialisé
+};
+
+const size_t BLOCK_HEADER_SIZE = 92;
+const size_t BLOCK_HEADER_NONCE_OFFSET = 84;
+
+inline void write_le32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+inline void write_le64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+inline uint32_t read_le32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+inline uint64_t read_le64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+struct BlockHeader {
+    uint32_t index;
+    int64_t timestamp;
+    Hash256 prevHash;
+    Hash256 dataHash;
+    uint32_t validatorId;
+    uint32_t bits;
+    uint64_t nonce;
+
+    void Serialize(uint8_t* out) const {
+        write_le32(out, index);
+        write_le64(out + 4, static_cast<uint64_t>(timestamp));
+        std::memcpy(out + 12, prevHash.data(), prevHash.size());
+        std::memcpy(out + 44, dataHash.data(), dataHash.size());
+        write_le32(out + 76, validatorId);
+        write_le32(out + 80, bits);
+        write_le64(out + BLOCK_HEADER_NONCE_OFFSET, nonce);
+    }
+
+    static BlockHeader Deserialize(const uint8_t* in) {
+        BlockHeader header;
+        header.index = read_le32(in);
+        header.timestamp = static_cast<int64_t>(read_le64(in + 4));
+        std::memcpy(header.prevHash.data(), in + 12, header.prevHash.size());
+        std::memcpy(header.dataHash.data(), in + 44, header.dataHash.size());
+        header.validatorId = read_le32(in + 76);
+        header.bits = read_le32(in + 80);
+        header.nonce = read_le64(in + BLOCK_HEADER_NONCE_OFFSET);
+        return header;
+    }
+
+    Hash256 Hash(HashMethod method) const {
+        uint8_t buffer[BLOCK_HEADER_SIZE];
+        Serialize(buffer);
+        return compute_hash_raw(method, buffer, BLOCK_HEADER_SIZE);
+    }
+};
+
+/**
+ * @class HeaderNonceHasher
+ * Équivalent de NonceHasher pour le format BINARY_HEADER : l'en-tête est
+ * sérialisé une fois dans un buffer, puis seul le champ nonce est réécrit.
+ * En SHA256, les 64 premiers octets (un bloc de compression complet) ne
+ * dépendent pas du nonce : ils sont absorbés une fois dans un midstate.
+ */
+class HeaderNonceHasher {
+private:
+    uint8_t _buffer[BLOCK_HEADER_SIZE];
+    HashMethod _hMethod;
+    SHA256 _shaMidstate;
+
+public:
+    HeaderNonceHasher(HashMethod method, const BlockHeader& header) : _hMethod(method) {
+        header.Serialize(_buffer);
+        if (_hMethod == HashMethod::SHA256) {
+            _shaMidstate.update(_buffer, 64);
+        }
+    }
+
+    void operator()(int64_t nonce, Hash256& out) {
+        write_le64(_buffer + BLOCK_HEADER_NONCE_OFFSET, static_cast<uint64_t>(nonce));
+
+        if (_hMethod == HashMethod::SHA256) {
+            SHA256 sha = _shaMidstate;
+            sha.update(_buffer + 64, BLOCK_HEADER_SIZE - 64);
+            sha.digest(out.data());
+            return;
+        }
+
+        out = compute_hash_raw(_hMethod, _buffer, BLOCK_HEADER_SIZE);
+    }
+};
+
+#endif // BLOCK_HEADER_HPP
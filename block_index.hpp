@@ -0,0 +1,158 @@
+#ifndef BLOCK_INDEX_HPP
+#define BLOCK_INDEX_HPP
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <stdexcept>
+
+#include "block_hash.hpp"
+#include "block_header.hpp"
+#include "block_store.hpp"
+
+/**
+ * Index des blocs : hash -> hauteur et hauteur -> position dans le stockage.
+ *
+ * - Table à adressage ouvert (sondage linéaire) indexée par le hash binaire
+ *   de 32 octets ; chaque case contient le hash et la hauteur du bloc.
+ *   Le hash est déjà uniformément réparti : ses 8 premiers octets, mélangés
+ *   par une multiplication de Fibonacci, donnent la case de départ.
+ * - Tableau dense hauteur -> BlockLocation (une entrée par bloc).
+ * Une recherche par hash coûte donc une ou deux lignes de cache au lieu d'un
+ * parcours linéaire de la chaîne avec comparaison de chaînes hexadécimales.
+ *
+ * Au démarrage, Sync() parcourt le stockage à partir du dernier point lu :
+ * un second appel ne lit que les blocs ajoutés entre-temps.
+ */
+
+struct BlockIndexEntry {
+    uint32_t height;
+    BlockLocation location;
+};
+
+class BlockIndex {
+private:
+    static const uint32_t EMPTY_SLOT = std::numeric_limits<uint32_t>::max();
+
+    struct Slot {
+        Hash256 hash;
+        uint32_t height; // EMPTY_SLOT si la case est libre
+    };
+
+    std::vector<Slot> _vSlots;             // taille : puissance de 2
+    unsigned _nShift;                      // 64 - log2(_vSlots.size())
+    std::vector<BlockLocation> _vLocations; // hauteur -> position
+    BlockLocation _resume;                  // prochain enregistrement à lire par Sync()
+
+    size_t _HomeSlot(const Hash256& hash) const {
+        return static_cast<size_t>((read_le64(hash.data()) * 0x9E3779B97F4A7C15ull) >> _nShift);
+    }
+
+    // Case contenant 'hash', ou première case libre rencontrée
+    size_t _Probe(const Hash256& hash) const {
+        const size_t mask = _vSlots.size() - 1;
+        size_t i = _HomeSlot(hash);
+        while (_vSlots[i].height != EMPTY_SLOT && _vSlots[i].hash != hash) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void _Rehash(size_t capacity) {
+        std::vector<Slot> old;
+        old.swap(_vSlots);
+        _vSlots.assign(capacity, Slot{Hash256(), EMPTY_SLOT});
+        _nShift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) {
+            --_nShift;
+        }
+        for (const Slot& slot : old) {
+            if (slot.height != EMPTY_SLOT) {
+                _vSlots[_Probe(slot.hash)] = slot;
+            }
+        }
+    }
+
+public:
+    BlockIndex() : _resume{0, 0} {
+        _Rehash(64);
+    }
+
+    size_t Size() const {
+        return _vLocations.size();
+    }
+
+    void Reserve(size_t nBlocks) {
+        _vLocations.reserve(nBlocks);
+        size_t capacity = _vSlots.size();
+        while (capacity < 2 * nBlocks) {
+            capacity *= 2;
+        }
+        if (capacity != _vSlots.size()) {
+            _Rehash(capacity);
+        }
+    }
+
+    /**
+     * @brief Indexe le bloc de hauteur Size() (les hauteurs sont denses).
+     * Un hash déjà indexé garde sa première hauteur.
+     */
+    void Add(const Hash256& hash, uint32_t height, const BlockLocation& location) {
+        if (height != _vLocations.size()) {
+            throw std::invalid_argument("BlockIndex: hauteur non contigue.");
+        }
+        // Facteur de charge <= 1/2 : sondages courts
+        if (2 * (_vLocations.size() + 1) > _vSlots.size()) {
+            _Rehash(2 * _vSlots.size());
+        }
+        _vLocations.push_back(location);
+        Slot& slot = _vSlots[_Probe(hash)];
+        if (slot.height == EMPTY_SLOT) {
+            slot.hash = hash;
+            slot.height = height;
+        }
+    }
+
+    /**
+     * @brief Indexe les blocs ajoutés au stockage depuis le dernier appel et
+     * appelle onNewBlock(const StoredBlock&) pour chacun. Les hauteurs déjà
+     * indexées (via Add) sont sautées.
+     */
+    template <class Fn>
+    size_t Sync(const BlockStore& store, Fn onNewBlock) {
+        size_t nAdded = 0;
+        Reserve(store.BlockCount());
+        _resume = store.Scan(_resume, [&](const StoredBlock& stored) {
+            if (stored.header.index < _vLocations.size()) {
+                return;
+            }
+            Add(stored.hash, stored.header.index, stored.location);
+            onNewBlock(stored);
+            ++nAdded;
+        });
+        return nAdded;
+    }
+
+    size_t Sync(const BlockStore& store) {
+        return Sync(store, [](const StoredBlock&) {});
+    }
+
+    /**
+     * @brief Cherche un bloc par son hash ; retourne false s'il est inconnu.
+     */
+    bool Find(const Hash256& hash, BlockIndexEntry& entry) const {
+        const Slot& slot = _vSlots[_Probe(hash)];
+        if (slot.height == EMPTY_SLOT) {
+            return false;
+        }
+        entry.height = slot.height;
+        entry.location = _vLocations[slot.height];
+        return true;
+    }
+
+    const BlockLocation& LocationAt(uint32_t height) const {
+        return _vLocations.at(height);
+    }
+};
+
+#endif // BLOCK_INDEX_HPP
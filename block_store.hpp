@@ -0,0 +1,388 @@
+#ifndef BLOCK_STORE_HPP
+#define BLOCK_STORE_HPP
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "block_hash.hpp"
+#include "block_header.hpp"
+
+/**
+ * Stockage persistant des blocs, en segments ajout-seul (POSIX).
+ *
+ * Un répertoire contient les segments blk00000.dat, blk00001.dat, ... Chaque
+ * segment est une suite d'enregistrements :
+ *
+ *   offset  taille  champ
+ *        0       4  magic "ACBK"
+ *        4       4  taille du contenu (payload)
+ *        8       4  CRC32 des octets 12 à la fin de l'enregistrement
+ *       12      92  BlockHeader sérialisé
+ *      104      32  hash du bloc
+ *      136       n  payload (opaque pour le stockage)
+ *
+ * Un nouveau segment est ouvert quand le suivant dépasserait la taille
+ * maximale. Les lectures passent par mmap : au redémarrage, un noeud projette
+ * ses segments en mémoire au lieu de re-miner ou de re-parser la chaîne.
+ * À l'ouverture, chaque CRC est vérifié. Un enregistrement incomplet ou dont
+ * le CRC est faux en fin du dernier segment (arrêt pendant une écriture) est
+ * tronqué ; ailleurs, c'est une corruption et le constructeur lève une exception.
+ *
+ * Non thread-safe : un seul thread écrit et lit à la fois.
+ */
+
+// Compromis durabilité / débit d'écriture
+enum class FsyncPolicy {
+    EVERY_BLOCK,    // fdatasync après chaque bloc
+    EVERY_N_BLOCKS, // fdatasync tous les N blocs
+    NEVER           // le système vide les pages quand il veut
+};
+
+const uint32_t BLOCK_RECORD_MAGIC = 0x4b424341; // "ACBK" en little-endian
+const size_t BLOCK_RECORD_CRC_OFFSET = 8;
+const size_t BLOCK_RECORD_HEADER_OFFSET = 12;
+const size_t BLOCK_RECORD_PREFIX_SIZE = BLOCK_RECORD_HEADER_OFFSET + BLOCK_HEADER_SIZE + 32;
+const uint64_t BLOCK_SEGMENT_DEFAULT_MAX_BYTES = 16u << 20;
+
+// CRC32 IEEE (polynôme réfléchi 0xEDB88320), table calculée au premier appel
+inline uint32_t crc32(const uint8_t* data, size_t len) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Position d'un enregistrement : numéro de segment + offset dans le segment
+struct BlockLocation {
+    uint32_t segment;
+    uint64_t offset;
+};
+
+// Vue sur un enregistrement ; 'payload' pointe dans la projection mémoire et
+// reste valide jusqu'au prochain Append() ou à la destruction du stockage.
+struct StoredBlock {
+    BlockHeader header;
+    Hash256 hash;
+    const uint8_t* payload;
+    uint32_t payloadSize;
+    BlockLocation location;
+};
+
+class BlockStore {
+private:
+    struct Segment {
+        int fd;
+        uint64_t size;    // octets valides
+        uint8_t* map;     // projection en lecture seule (nullptr si vide)
+        uint64_t mapSize; // octets projetés
+    };
+
+    std::string _sDirectory;
+    FsyncPolicy _ePolicy;
+    uint32_t _nFsyncInterval;
+    uint64_t _nSegmentMaxBytes;
+    mutable std::vector<Segment> _vSegments;
+    uint64_t _nBlocks;
+    uint32_t _nUnsynced; // blocs écrits depuis le dernier fdatasync
+    std::vector<uint8_t> _vRecord;
+
+    static void _Fail(const std::string& what) {
+        throw std::runtime_error("BlockStore: " + what + " (" + std::strerror(errno) + ")");
+    }
+
+    std::string _SegmentPath(uint32_t n) const {
+        char name[16];
+        std::snprintf(name, sizeof(name), "blk%05u.dat", n);
+        return _sDirectory + "/" + name;
+    }
+
+    void _Unmap(Segment& seg) const {
+        if (seg.map != nullptr) {
+            munmap(seg.map, seg.mapSize);
+            seg.map = nullptr;
+            seg.mapSize = 0;
+        }
+    }
+
+    // (Re)projette le segment s'il a grandi depuis la dernière projection
+    void _Map(Segment& seg) const {
+        if (seg.mapSize == seg.size) {
+            return;
+        }
+        _Unmap(seg);
+        if (seg.size == 0) {
+            return;
+        }
+        void* p = mmap(nullptr, seg.size, PROT_READ, MAP_SHARED, seg.fd, 0);
+        if (p == MAP_FAILED) {
+            _Fail("mmap");
+        }
+        seg.map = static_cast<uint8_t*>(p);
+        seg.mapSize = seg.size;
+    }
+
+    // Taille de l'enregistrement complet situé à 'offset', 0 s'il est invalide ou tronqué
+    static uint64_t _RecordSizeAt(const Segment& seg, uint64_t offset) {
+        if (seg.size - offset < BLOCK_RECORD_PREFIX_SIZE) {
+            return 0;
+        }
+        const uint8_t* p = seg.map + offset;
+        if (read_le32(p) != BLOCK_RECORD_MAGIC) {
+            return 0;
+        }
+        uint64_t total = BLOCK_RECORD_PREFIX_SIZE + read_le32(p + 4);
+        return (seg.size - offset < total) ? 0 : total;
+    }
+
+    static bool _RecordCrcMatches(const Segment& seg, uint64_t offset, uint64_t recordSize) {
+        const uint8_t* p = seg.map + offset;
+        return read_le32(p + BLOCK_RECORD_CRC_OFFSET) ==
+               crc32(p + BLOCK_RECORD_HEADER_OFFSET, recordSize - BLOCK_RECORD_HEADER_OFFSET);
+    }
+
+    void _OpenSegment(uint32_t n, bool create) {
+        _vSegments.reserve(_vSegments.size() + 1); // push_back ne peut plus lever après open()
+        int fd = open(_SegmentPath(n).c_str(), O_RDWR | (create ? O_CREAT : 0), 0644);
+        if (fd < 0) {
+            _Fail("ouverture de " + _SegmentPath(n));
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            _Fail("fstat");
+        }
+        _vSegments.push_back(Segment{fd, static_cast<uint64_t>(st.st_size), nullptr, 0});
+    }
+
+    // Parcourt un segment à l'ouverture : compte les blocs, vérifie les CRC et
+    // coupe une fin incomplète (dernier segment seulement ; ailleurs, c'est une corruption)
+    void _Recover(Segment& seg, bool bLast) {
+        _Map(seg);
+        uint64_t offset = 0;
+        while (offset < seg.size) {
+            uint64_t recordSize = _RecordSizeAt(seg, offset);
+            if (recordSize == 0) {
+                break;
+            }
+            if (!_RecordCrcMatches(seg, offset, recordSize)) {
+                if (!bLast || offset + recordSize != seg.size) {
+                    throw std::runtime_error("BlockStore: CRC d'enregistrement incorrect.");
+                }
+                break; // dernier enregistrement partiellement écrit
+            }
+            offset += recordSize;
+            ++_nBlocks;
+        }
+        if (offset != seg.size) {
+            if (!bLast) {
+                throw std::runtime_error("BlockStore: segment scelle corrompu.");
+            }
+            if (ftruncate(seg.fd, static_cast<off_t>(offset)) != 0) {
+                _Fail("ftruncate");
+            }
+            seg.size = offset;
+            _Map(seg);
+        }
+    }
+
+    void _SyncActive() {
+        if (!_vSegments.empty() && fdatasync(_vSegments.back().fd) != 0) {
+            _Fail("fdatasync");
+        }
+        _nUnsynced = 0;
+    }
+
+    void _CloseAll() {
+        for (auto& seg : _vSegments) {
+            _Unmap(seg);
+            close(seg.fd);
+        }
+        _vSegments.clear();
+    }
+
+public:
+    /**
+     * @param directory Répertoire des segments (créé s'il n'existe pas).
+     * @param policy Politique de fdatasync des ajouts.
+     * @param fsyncInterval N pour FsyncPolicy::EVERY_N_BLOCKS.
+     * @param segmentMaxBytes Taille à partir de laquelle un nouveau segment est ouvert.
+     */
+    explicit BlockStore(const std::string& directory, FsyncPolicy policy = FsyncPolicy::EVERY_BLOCK,
+                        uint32_t fsyncInterval = 16,
+                        uint64_t segmentMaxBytes = BLOCK_SEGMENT_DEFAULT_MAX_BYTES)
+        : _sDirectory(directory), _ePolicy(policy), _nFsyncInterval(fsyncInterval ? fsyncInterval : 1),
+          _nSegmentMaxBytes(segmentMaxBytes), _nBlocks(0), _nUnsynced(0) {
+        if (mkdir(_sDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+            _Fail("creation de " + _sDirectory);
+        }
+
+        // Segments existants, dans l'ordre ; seule la fin du dernier peut être incomplète.
+        // Le destructeur n'est pas appelé si le constructeur lève : on ferme ici.
+        try {
+            for (uint32_t n = 0; access(_SegmentPath(n).c_str(), F_OK) == 0; ++n) {
+                _OpenSegment(n, false);
+            }
+            for (size_t i = 0; i < _vSegments.size(); ++i) {
+                _Recover(_vSegments[i], i + 1 == _vSegments.size());
+            }
+            if (_vSegments.empty()) {
+                _OpenSegment(0, true);
+            }
+        } catch (...) {
+            _CloseAll();
+            throw;
+        }
+    }
+
+    ~BlockStore() {
+        if (_ePolicy != FsyncPolicy::NEVER && _nUnsynced > 0 && !_vSegments.empty()) {
+            fdatasync(_vSegments.back().fd);
+        }
+        _CloseAll();
+    }
+
+    BlockStore(const BlockStore&) = delete;
+    BlockStore& operator=(const BlockStore&) = delete;
+
+    uint64_t BlockCount() const { return _nBlocks; }
+    size_t SegmentCount() const { return _vSegments.size(); }
+
+    /**
+     * @brief Ajoute un bloc en fin de stockage et retourne sa position.
+     */
+    BlockLocation Append(const BlockHeader& header, const Hash256& hash,
+                         const uint8_t* payload, size_t payloadSize) {
+        if (payloadSize > UINT32_MAX) {
+            throw std::invalid_argument("BlockStore: payload trop grand.");
+        }
+        const uint64_t recordSize = BLOCK_RECORD_PREFIX_SIZE + payloadSize;
+
+        if (_vSegments.back().size > 0 && _vSegments.back().size + recordSize > _nSegmentMaxBytes) {
+            if (_ePolicy != FsyncPolicy::NEVER) {
+                _SyncActive(); // le segment scellé est durable avant d'en ouvrir un autre
+            }
+            _OpenSegment(static_cast<uint32_t>(_vSegments.size()), true);
+        }
+
+        // Un seul write() par bloc
+        _vRecord.resize(recordSize);
+        write_le32(_vRecord.data(), BLOCK_RECORD_MAGIC);
+        write_le32(_vRecord.data() + 4, static_cast<uint32_t>(payloadSize));
+        header.Serialize(_vRecord.data() + BLOCK_RECORD_HEADER_OFFSET);
+        std::memcpy(_vRecord.data() + BLOCK_RECORD_HEADER_OFFSET + BLOCK_HEADER_SIZE, hash.data(), hash.size());
+        if (payloadSize > 0) {
+            std::memcpy(_vRecord.data() + BLOCK_RECORD_PREFIX_SIZE, payload, payloadSize);
+        }
+        write_le32(_vRecord.data() + BLOCK_RECORD_CRC_OFFSET,
+                   crc32(_vRecord.data() + BLOCK_RECORD_HEADER_OFFSET, recordSize - BLOCK_RECORD_HEADER_OFFSET));
+
+        Segment& seg = _vSegments.back();
+        BlockLocation location{static_cast<uint32_t>(_vSegments.size() - 1), seg.size};
+        size_t written = 0;
+        while (written < recordSize) {
+            ssize_t n = pwrite(seg.fd, _vRecord.data() + written, recordSize - written,
+                               static_cast<off_t>(seg.size + written));
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                _Fail("ecriture");
+            }
+            written += static_cast<size_t>(n);
+        }
+        seg.size += recordSize;
+        ++_nBlocks;
+        ++_nUnsynced;
+
+        if (_ePolicy == FsyncPolicy::EVERY_BLOCK ||
+            (_ePolicy == FsyncPolicy::EVERY_N_BLOCKS && _nUnsynced >= _nFsyncInterval)) {
+            _SyncActive();
+        }
+        return location;
+    }
+
+    /**
+     * @brief Force l'écriture sur disque des blocs ajoutés (quelle que soit la politique).
+     */
+    void Sync() {
+        _SyncActive();
+    }
+
+    /**
+     * @brief Lit l'enregistrement situé à 'location' via la projection mémoire.
+     */
+    StoredBlock Read(const BlockLocation& location) const {
+        if (location.segment >= _vSegments.size()) {
+            throw std::out_of_range("BlockStore: segment inexistant.");
+        }
+        Segment& seg = _vSegments[location.segment];
+        _Map(seg);
+        if (location.offset >= seg.size || _RecordSizeAt(seg, location.offset) == 0) {
+            throw std::out_of_range("BlockStore: aucun bloc a cette position.");
+        }
+
+        const uint8_t* p = seg.map + location.offset;
+        StoredBlock block;
+        block.header = BlockHeader::Deserialize(p + BLOCK_RECORD_HEADER_OFFSET);
+        std::memcpy(block.hash.data(), p + BLOCK_RECORD_HEADER_OFFSET + BLOCK_HEADER_SIZE, block.hash.size());
+        block.payloadSize = read_le32(p + 4);
+        block.payload = p + BLOCK_RECORD_PREFIX_SIZE;
+        block.location = location;
+        return block;
+    }
+
+    /**
+     * @brief Appelle fn(const StoredBlock&) pour chaque bloc à partir de 'from',
+     * dans l'ordre d'ajout. Retourne la position qui suit le dernier bloc lu
+     * (point de reprise pour un parcours incrémental).
+     */
+    template <class Fn>
+    BlockLocation Scan(BlockLocation from, Fn fn) const {
+        BlockLocation location = from;
+        while (location.segment < _vSegments.size()) {
+            Segment& seg = _vSegments[location.segment];
+            _Map(seg);
+            if (location.offset >= seg.size) {
+                if (location.segment + 1 == _vSegments.size()) {
+                    break; // fin du segment actif : on reprendra ici
+                }
+                location = BlockLocation{location.segment + 1, 0};
+                continue;
+            }
+            StoredBlock block = Read(location);
+            fn(block);
+            location.offset += BLOCK_RECORD_PREFIX_SIZE + block.payloadSize;
+        }
+        return location;
+    }
+
+    template <class Fn>
+    BlockLocation ForEach(Fn fn) const {
+        return Scan(BlockLocation{0, 0}, fn);
+    }
+};
+
+#endif // BLOCK_STORE_HPP
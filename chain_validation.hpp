@@ -0,0 +1,137 @@
+#ifndef CHAIN_VALIDATION_HPP
+#define CHAIN_VALIDATION_HPP
+
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <cstdint>
+
+#include "block_hash.hpp"
+#include "pow_target.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * Validation parallèle d'une chaîne PoW (Blockchain::isChainValidPoW).
+ *
+ * 1. Le recalcul du hash de chaque bloc est indépendant : il est réparti sur
+ *    le pool de threads par morceaux de blocs consécutifs.
+ *    Un bloc miné contre une cible compacte (GetBits() != 0) doit aussi
+ *    avoir un hash <= target_from_compact(GetBits()).
+ * 2. Le chaînage (prevHash == hash du bloc précédent) est une simple
+ *    comparaison de 32 octets : il est vérifié en une passe séquentielle.
+ * Le premier bloc fautif est déterministe : un échec de hash et un échec de
+ * chaînage au même index sont rapportés comme un échec de hash, dans l'ordre
+ * de la version séquentielle.
+ */
+
+enum class ValidationError {
+    NONE,
+    BAD_HASH,   // le hash stocké ne correspond pas au hash recalculé
+    BROKEN_LINK, // prevHash ne pointe pas vers le hash du bloc précédent
+    BAD_TARGET   // hash correct mais au-dessus de la cible engagée dans le bloc
+};
+
+struct ValidationResult {
+    bool valid;
+    size_t badIndex;        // premier bloc fautif (si !valid)
+    ValidationError reason;
+    Hash256 expected;       // BAD_HASH : hash recalculé ; BAD_TARGET : cible
+    Hash256 actual;         // BAD_HASH / BAD_TARGET : hash stocké
+
+    const char* Reason() const {
+        switch (reason) {
+            case ValidationError::BAD_HASH:    return "Hash incorrect";
+            case ValidationError::BROKEN_LINK: return "Chaine rompue";
+            case ValidationError::BAD_TARGET:  return "Hash au-dessus de la cible";
+            case ValidationError::NONE:        default: return "OK";
+        }
+    }
+};
+
+// Taille des morceaux distribués aux threads (assez gros pour amortir l'atomique)
+const size_t VALIDATION_CHUNK_BLOCKS = 256;
+
+// Cible du bloc respectée (toujours vrai sans cible compacte) ; "bits" invalide : refusé
+inline bool validation_meets_bits(const Hash256& hash, uint32_t nBits) {
+    if (nBits == 0) {
+        return true;
+    }
+    try {
+        return hash_meets_target(hash, target_from_compact(nBits));
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Valide une chaîne dont les blocs exposent 'hash', 'prevHash',
+ * recalculatePoWHash() et GetBits() (Block de q3.cpp / q4.cpp). Le bloc 0 (Genesis) n'est
+ * pas vérifié, comme dans la version séquentielle.
+ */
+template <class BlockT>
+ValidationResult validate_chain_pow(const std::vector<BlockT>& chain, ThreadPool& pool) {
+    const size_t noError = std::numeric_limits<size_t>::max();
+    ValidationResult result;
+    result.valid = true;
+    result.badIndex = 0;
+    result.reason = ValidationError::NONE;
+    result.expected = Hash256();
+    result.actual = Hash256();
+
+    if (chain.size() < 2) {
+        return result;
+    }
+
+    // 1. Recalcul des hashes en parallèle ; on garde le plus petit index fautif.
+    //    Les morceaux situés après un échec déjà trouvé sont sautés.
+    std::atomic<size_t> firstBadHash(noError);
+    pool.ParallelFor(chain.size() - 1, VALIDATION_CHUNK_BLOCKS, [&](size_t begin, size_t end) {
+        for (size_t i = begin + 1; i <= end; ++i) {
+            if (i >= firstBadHash.load(std::memory_order_relaxed)) {
+                return;
+            }
+            if (chain[i].hash != chain[i].recalculatePoWHash() ||
+                !validation_meets_bits(chain[i].hash, chain[i].GetBits())) {
+                size_t current = firstBadHash.load();
+                while (i < current && !firstBadHash.compare_exchange_weak(current, i)) {
+                }
+                return;
+            }
+        }
+    });
+
+    // 2. Chaînage : une passe séquentielle jusqu'au premier hash fautif.
+    size_t firstBadLink = noError;
+    size_t linkLimit = (firstBadHash.load() == noError) ? chain.size() : firstBadHash.load();
+    for (size_t i = 1; i < linkLimit; ++i) {
+        if (chain[i].prevHash != chain[i - 1].hash) {
+            firstBadLink = i;
+            break;
+        }
+    }
+
+    if (firstBadLink != noError) {
+        result.valid = false;
+        result.badIndex = firstBadLink;
+        result.reason = ValidationError::BROKEN_LINK;
+    } else if (firstBadHash.load() != noError) {
+        const BlockT& block = chain[firstBadHash.load()];
+        result.valid = false;
+        result.badIndex = firstBadHash.load();
+        result.actual = block.hash;
+        result.expected = block.recalculatePoWHash();
+        if (result.expected == block.hash) {
+            result.reason = ValidationError::BAD_TARGET;
+            try {
+                result.expected = target_from_compact(block.GetBits());
+            } catch (const std::exception&) {
+                result.expected = Hash256(); // "bits" non décodable
+            }
+        } else {
+            result.reason = ValidationError::BAD_HASH;
+        }
+    }
+    return result;
+}
+
+#endif // CHAIN_VALIDATION_HPP
@@ -0,0 +1,237 @@
+#ifndef MEMPOOL_HPP
+#define MEMPOOL_HPP
+
+#include <set>
+#include <deque>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "sha256.hpp"
+#include "block_hash.hpp"
+
+/**
+ * Mempool : transactions en attente d'inclusion dans un bloc.
+ *
+ * - Submit() est appelable depuis n'importe quel thread : l'identifiant
+ *   (SHA256 de la transaction) est calculé par l'appelant, puis la
+ *   transaction est ajoutée à une file d'entrée protégée par un mutex court.
+ * - ProcessIncoming() vide la file par lots : dé-duplication par identifiant,
+ *   insertion dans l'index de priorité, puis éviction des transactions au
+ *   plus faible taux de frais tant que la taille dépasse la limite.
+ *   Les identifiants sortis du pool (inclus dans un bloc ou évincés) restent
+ *   dans un ensemble "déjà vus" borné, vidé dans l'ordre FIFO : une
+ *   rediffusion tardive compte comme doublon au lieu de revenir dans le pool.
+ * - AssembleBlock() prend les transactions par taux de frais décroissant
+ *   (à taux égal, la plus ancienne d'abord) sous un budget en octets ; le
+ *   coût dépend du nombre de transactions retenues, pas de la taille du pool.
+ */
+
+struct Hash256Hasher {
+    size_t operator()(const Hash256& hash) const {
+        size_t value;
+        std::memcpy(&value, hash.data(), sizeof(value)); // le hash est déjà uniforme
+        return value;
+    }
+};
+
+struct MempoolStats {
+    uint64_t accepted;
+    uint64_t duplicates;
+    uint64_t evicted;
+};
+
+// Après autant de transactions trop grosses pour le budget restant, le bloc est considéré plein
+const size_t MEMPOOL_MAX_ASSEMBLY_SKIPS = 1000;
+
+// Identifiants sortis du pool mémorisés par défaut (32 octets chacun, plus l'index)
+const size_t MEMPOOL_DEFAULT_RECENT_TXIDS = 100000;
+
+class Mempool {
+private:
+    struct PendingTx {
+        Hash256 txid;
+        std::string payload;
+        uint64_t fee;
+    };
+
+    // Clé de priorité : meilleur taux de frais d'abord, puis ordre d'arrivée
+    struct PriorityKey {
+        uint64_t feeRate; // frais par kilo-octet
+        uint64_t sequence;
+        size_t size;      // l'assemblage parcourt l'index sans toucher à la table
+        Hash256 txid;
+
+        bool operator<(const PriorityKey& other) const {
+            if (feeRate != other.feeRate) {
+                return feeRate > other.feeRate;
+            }
+            return sequence < other.sequence;
+        }
+    };
+
+    struct Entry {
+        std::string payload;
+        uint64_t fee;
+        uint64_t feeRate;
+        uint64_t sequence;
+    };
+
+    size_t _nMaxBytes;
+
+    std::mutex _queueMutex;
+    std::vector<PendingTx> _vIncoming;
+
+    mutable std::mutex _poolMutex;
+    std::unordered_map<Hash256, Entry, Hash256Hasher> _byId;
+    std::set<PriorityKey> _byPriority;
+    size_t _nBytes;
+    uint64_t _nSequence;
+    MempoolStats _stats;
+
+    // Identifiants sortis du pool : _recent pour la recherche, _recentOrder pour le FIFO
+    size_t _nMaxRecent;
+    std::unordered_set<Hash256, Hash256Hasher> _recent;
+    std::deque<Hash256> _recentOrder;
+
+    void _Remember(const Hash256& txid) {
+        if (_nMaxRecent == 0 || !_recent.insert(txid).second) {
+            return;
+        }
+        _recentOrder.push_back(txid);
+        if (_recentOrder.size() > _nMaxRecent) {
+            _recent.erase(_recentOrder.front());
+            _recentOrder.pop_front();
+        }
+    }
+
+    // fee * 1000 / size sans débordement : saturé à UINT64_MAX pour les frais énormes
+    static uint64_t _FeeRate(uint64_t fee, size_t size) {
+        const uint64_t divisor = size ? size : 1;
+        const uint64_t whole = fee / divisor;
+        if (whole > (UINT64_MAX - 999) / 1000) {
+            return UINT64_MAX;
+        }
+        const uint64_t remainder = fee % divisor;
+        const uint64_t fraction = (remainder <= UINT64_MAX / 1000) ? remainder * 1000 / divisor
+                                                                   : remainder / (divisor / 1000);
+        return whole * 1000 + fraction;
+    }
+
+    void _Remove(std::unordered_map<Hash256, Entry, Hash256Hasher>::iterator it) {
+        _byPriority.erase(PriorityKey{it->second.feeRate, it->second.sequence, 0, it->first});
+        _nBytes -= it->second.payload.size();
+        _Remember(it->first);
+        _byId.erase(it);
+    }
+
+public:
+    /**
+     * @param nMaxBytes Taille maximale cumulée des transactions en attente.
+     * @param nMaxRecent Identifiants sortis du pool encore refusés (0 : aucun).
+     */
+    explicit Mempool(size_t nMaxBytes, size_t nMaxRecent = MEMPOOL_DEFAULT_RECENT_TXIDS)
+        : _nMaxBytes(nMaxBytes), _nBytes(0), _nSequence(0), _stats{0, 0, 0}, _nMaxRecent(nMaxRecent) {
+    }
+
+    Mempool(const Mempool&) = delete;
+    Mempool& operator=(const Mempool&) = delete;
+
+    /**
+     * @brief Soumet une transaction (thread-safe). Elle n'est visible par
+     * AssembleBlock() qu'après le prochain ProcessIncoming().
+     */
+    void Submit(std::string payload, uint64_t fee) {
+        PendingTx tx{sha256_raw(payload), std::move(payload), fee};
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _vIncoming.push_back(std::move(tx));
+    }
+
+    /**
+     * @brief Intègre les transactions soumises ; retourne le nombre traité.
+     */
+    size_t ProcessIncoming() {
+        std::vector<PendingTx> batch;
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+            batch.swap(_vIncoming);
+        }
+
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        for (PendingTx& tx : batch) {
+            if (_byId.count(tx.txid) != 0 || _recent.count(tx.txid) != 0) {
+                ++_stats.duplicates;
+                continue;
+            }
+            uint64_t feeRate = _FeeRate(tx.fee, tx.payload.size());
+            uint64_t sequence = _nSequence++;
+            _nBytes += tx.payload.size();
+            _byPriority.insert(PriorityKey{feeRate, sequence, tx.payload.size(), tx.txid});
+            _byId.emplace(tx.txid, Entry{std::move(tx.payload), tx.fee, feeRate, sequence});
+            ++_stats.accepted;
+        }
+
+        // Éviction par la queue de l'index : taux de frais le plus faible, puis la plus récente
+        while (_nBytes > _nMaxBytes && !_byPriority.empty()) {
+            _Remove(_byId.find(std::prev(_byPriority.end())->txid));
+            ++_stats.evicted;
+        }
+        return batch.size();
+    }
+
+    /**
+     * @brief Retire du pool et retourne les meilleures transactions (au plus
+     * 'nMaxTx') dont la taille cumulée tient dans 'nMaxBytes'.
+     */
+    std::vector<std::string> AssembleBlock(size_t nMaxBytes, size_t nMaxTx = SIZE_MAX) {
+        std::vector<std::string> selected;
+        std::vector<std::set<PriorityKey>::iterator> taken;
+        std::lock_guard<std::mutex> lock(_poolMutex);
+
+        size_t nRemaining = nMaxBytes;
+        size_t nSkips = 0;
+        for (auto key = _byPriority.begin(); key != _byPriority.end() && taken.size() < nMaxTx; ++key) {
+            if (key->size > nRemaining) {
+                if (++nSkips >= MEMPOOL_MAX_ASSEMBLY_SKIPS) {
+                    break;
+                }
+                continue;
+            }
+            nRemaining -= key->size;
+            taken.push_back(key);
+        }
+
+        selected.reserve(taken.size());
+        for (auto key : taken) {
+            auto it = _byId.find(key->txid);
+            selected.push_back(std::move(it->second.payload));
+            _Remember(it->first);
+            _byId.erase(it);
+            _byPriority.erase(key);
+        }
+        _nBytes -= nMaxBytes - nRemaining;
+        return selected;
+    }
+
+    size_t Size() const {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        return _byId.size();
+    }
+
+    size_t Bytes() const {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        return _nBytes;
+    }
+
+    MempoolStats Stats() const {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        return _stats;
+    }
+};
+
+#endif // MEMPOOL_HPP
@@ -0,0 +1,158 @@
+#ifndef MERKLE_HPP
+#define MERKLE_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "block_hash.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * Arbre de Merkle des transactions d'un bloc.
+ *
+ * Seule la racine entre dans l'en-tête haché (BlockHeader::dataHash) : le
+ * coût d'un essai de nonce ne dépend plus de la taille du bloc.
+ *
+ * - feuille : H(0x00 || transaction), noeud : H(0x01 || gauche || droite),
+ *   avec H = SHA256 ou AC_HASH selon la HashMethod. Les préfixes empêchent de
+ *   faire passer un noeud interne pour une transaction.
+ * - un noeud sans frère (niveau de taille impaire) remonte tel quel au niveau
+ *   suivant, au lieu d'être dupliqué : deux listes différentes ne peuvent pas
+ *   donner la même racine.
+ * - les niveaux assez larges sont hachés en parallèle sur le ThreadPool.
+ * - la racine d'une liste vide est le hash nul.
+ */
+
+// En dessous, le coût de distribution dépasse le gain du parallélisme
+const size_t MERKLE_PARALLEL_MIN_NODES = 1024;
+const size_t MERKLE_CHUNK_NODES = 256;
+
+struct MerkleProofStep {
+    Hash256 sibling;
+    bool siblingOnLeft;
+};
+
+// Chemin d'une feuille vers la racine (les niveaux sans frère sont omis)
+struct MerkleProof {
+    size_t index;
+    std::vector<MerkleProofStep> steps;
+};
+
+inline Hash256 merkle_leaf_hash(HashMethod method, const std::string& transaction) {
+    if (method == HashMethod::SHA256) {
+        const uint8_t prefix = 0x00;
+        SHA256 sha;
+        sha.update(&prefix, 1);
+        sha.update(transaction);
+        return sha.digest();
+    }
+    std::string buffer;
+    buffer.reserve(1 + transaction.size());
+    buffer.push_back('\0');
+    buffer += transaction;
+    return compute_hash_raw(method, buffer);
+}
+
+inline Hash256 merkle_node_hash(HashMethod method, const Hash256& left, const Hash256& right) {
+    uint8_t buffer[1 + 2 * 32];
+    buffer[0] = 0x01;
+    std::memcpy(buffer + 1, left.data(), 32);
+    std::memcpy(buffer + 33, right.data(), 32);
+    return compute_hash_raw(method, buffer, sizeof(buffer));
+}
+
+class MerkleTree {
+private:
+    HashMethod _hMethod;
+    std::vector<std::vector<Hash256>> _vLevels; // [0] = feuilles, back() = racine
+
+    // fn(begin, end) sur [0, count), en parallèle si le niveau est assez large
+    template <class Fn>
+    static void _ForRange(ThreadPool* pool, size_t count, Fn fn) {
+        if (pool != nullptr && count >= MERKLE_PARALLEL_MIN_NODES) {
+            pool->ParallelFor(count, MERKLE_CHUNK_NODES, fn);
+        } else {
+            fn(0, count);
+        }
+    }
+
+public:
+    /**
+     * @param pool Pool utilisé pour les grands blocs (nullptr : séquentiel).
+     * Le résultat ne dépend pas du nombre de threads.
+     */
+    MerkleTree(HashMethod method, const std::vector<std::string>& transactions, ThreadPool* pool = nullptr)
+        : _hMethod(method) {
+        if (transactions.empty()) {
+            return;
+        }
+
+        _vLevels.emplace_back(transactions.size());
+        std::vector<Hash256>& leaves = _vLevels.back();
+        _ForRange(pool, transactions.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                leaves[i] = merkle_leaf_hash(_hMethod, transactions[i]);
+            }
+        });
+
+        while (_vLevels.back().size() > 1) {
+            const size_t nBelow = _vLevels.back().size();
+            _vLevels.emplace_back((nBelow + 1) / 2);
+            const std::vector<Hash256>& below = _vLevels[_vLevels.size() - 2];
+            std::vector<Hash256>& level = _vLevels.back();
+            _ForRange(pool, level.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    level[i] = (2 * i + 1 < nBelow) ? merkle_node_hash(_hMethod, below[2 * i], below[2 * i + 1])
+                                                    : below[2 * i];
+                }
+            });
+        }
+    }
+
+    size_t LeafCount() const {
+        return _vLevels.empty() ? 0 : _vLevels[0].size();
+    }
+
+    Hash256 Root() const {
+        return _vLevels.empty() ? Hash256() : _vLevels.back()[0];
+    }
+
+    /**
+     * @brief Preuve d'inclusion de la transaction 'index' : log2(n) hashes.
+     */
+    MerkleProof Proof(size_t index) const {
+        if (index >= LeafCount()) {
+            throw std::out_of_range("MerkleTree: transaction inexistante.");
+        }
+        MerkleProof proof;
+        proof.index = index;
+        size_t pos = index;
+        for (size_t depth = 0; depth + 1 < _vLevels.size(); ++depth) {
+            const std::vector<Hash256>& level = _vLevels[depth];
+            size_t sibling = pos ^ 1;
+            if (sibling < level.size()) {
+                proof.steps.push_back(MerkleProofStep{level[sibling], (pos & 1) != 0});
+            }
+            pos /= 2;
+        }
+        return proof;
+    }
+
+    /**
+     * @brief Vérifie qu'une transaction appartient à l'arbre de racine 'root'.
+     */
+    static bool Verify(HashMethod method, const std::string& transaction, const MerkleProof& proof,
+                       const Hash256& root) {
+        Hash256 current = merkle_leaf_hash(method, transaction);
+        for (const MerkleProofStep& step : proof.steps) {
+            current = step.siblingOnLeft ? merkle_node_hash(method, step.sibling, current)
+                                         : merkle_node_hash(method, current, step.sibling);
+        }
+        return current == root;
+    }
+};
+
+#endif // MERKLE_HPP
@@ -0,0 +1,290 @@
+#ifndef MINING_TELEMETRY_HPP
+#define MINING_TELEMETRY_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdint>
+
+#include "block_hash.hpp"
+
+/**
+ * Télémétrie du minage, lisible depuis un autre thread pendant le minage.
+ *
+ * - compteurs par thread de minage (une ligne de cache chacun) : hashes
+ *   tentés et temps passé à miner ; le ParallelMiner les publie tous les
+ *   64 hashes avec un fetch_add relaxed, comme ses propres compteurs ;
+ * - par (méthode, difficulté) : blocs minés, hashes, histogramme du temps
+ *   de résolution et histogramme des nonces gagnants (puissances de 2) ;
+ * - journal des blocs (hauteur, méthode, difficulté, nonce, hashes, durée).
+ * Export au format texte Prometheus, et du journal en CSV.
+ */
+
+const size_t TELEMETRY_METHODS = 2;          // HashMethod::SHA256, HashMethod::AC_HASH
+const size_t TELEMETRY_MAX_DIFFICULTY = 64;  // 64 quartets = 256 bits
+const size_t TELEMETRY_NONCE_BUCKETS = 64;   // bucket b : nonces dans [2^b, 2^(b+1))
+const double TELEMETRY_SOLVE_BUCKETS[] = {0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 50, 100};
+const size_t TELEMETRY_SOLVE_BUCKET_COUNT = sizeof(TELEMETRY_SOLVE_BUCKETS) / sizeof(TELEMETRY_SOLVE_BUCKETS[0]);
+
+struct BlockTiming {
+    uint64_t height;
+    HashMethod method;
+    uint32_t difficulty;
+    int64_t nonce;
+    uint64_t hashes;
+    double seconds;
+};
+
+class MiningTelemetry {
+private:
+    struct alignas(64) ThreadSlot {
+        std::atomic<uint64_t> hashes;
+        std::atomic<uint64_t> busyNanos;  // minages terminés
+        std::atomic<int64_t> startNanos;  // début du minage en cours, -1 si inactif
+    };
+
+    struct DifficultyStats {
+        std::atomic<uint64_t> blocks;
+        std::atomic<uint64_t> hashes;
+        std::atomic<uint64_t> solveNanos;
+        std::atomic<uint64_t> solveBuckets[TELEMETRY_SOLVE_BUCKET_COUNT + 1]; // dernier : +Inf
+        std::atomic<uint64_t> nonceBuckets[TELEMETRY_NONCE_BUCKETS];
+        std::atomic<uint64_t> nonceSum;
+    };
+
+    unsigned _nThreads;
+    std::unique_ptr<ThreadSlot[]> _pThreads;
+    std::unique_ptr<DifficultyStats[]> _pStats; // [méthode][difficulté]
+    std::chrono::steady_clock::time_point _tOrigin;
+
+    mutable std::mutex _logMutex;
+    std::vector<BlockTiming> _vBlockLog;
+
+    int64_t _NowNanos() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _tOrigin).count();
+    }
+
+    DifficultyStats& _Stats(HashMethod method, uint32_t difficulty) const {
+        size_t d = difficulty > TELEMETRY_MAX_DIFFICULTY ? TELEMETRY_MAX_DIFFICULTY : difficulty;
+        return _pStats[static_cast<size_t>(method) * (TELEMETRY_MAX_DIFFICULTY + 1) + d];
+    }
+
+    static std::string _Labels(HashMethod method, uint32_t difficulty) {
+        return std::string("method=\"") + hash_method_name(method) + "\",difficulty=\"" + std::to_string(difficulty) + "\"";
+    }
+
+public:
+    explicit MiningTelemetry(unsigned nThreads)
+        : _nThreads(nThreads), _pThreads(new ThreadSlot[nThreads]),
+          _pStats(new DifficultyStats[TELEMETRY_METHODS * (TELEMETRY_MAX_DIFFICULTY + 1)]()),
+          _tOrigin(std::chrono::steady_clock::now()) {
+        for (unsigned t = 0; t < _nThreads; ++t) {
+            _pThreads[t].hashes.store(0);
+            _pThreads[t].busyNanos.store(0);
+            _pThreads[t].startNanos.store(-1);
+        }
+    }
+
+    MiningTelemetry(const MiningTelemetry&) = delete;
+    MiningTelemetry& operator=(const MiningTelemetry&) = delete;
+
+    unsigned ThreadCount() const {
+        return _nThreads;
+    }
+
+    // --- Côté mineur (threads de minage) ---
+
+    void BeginMining(unsigned thread) {
+        _pThreads[thread].startNanos.store(_NowNanos(), std::memory_order_relaxed);
+    }
+
+    void AddHashes(unsigned thread, uint64_t nHashes) {
+        _pThreads[thread].hashes.fetch_add(nHashes, std::memory_order_relaxed);
+    }
+
+    void EndMining(unsigned thread) {
+        ThreadSlot& slot = _pThreads[thread];
+        int64_t start = slot.startNanos.exchange(-1, std::memory_order_relaxed);
+        if (start >= 0) {
+            slot.busyNanos.fetch_add(static_cast<uint64_t>(_NowNanos() - start), std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Enregistre un bloc miné (appelé une fois par bloc par la chaîne).
+     */
+    void RecordBlock(uint64_t height, HashMethod method, uint32_t difficulty, int64_t nonce,
+                     uint64_t hashes, double seconds) {
+        DifficultyStats& stats = _Stats(method, difficulty);
+        stats.blocks.fetch_add(1, std::memory_order_relaxed);
+        stats.hashes.fetch_add(hashes, std::memory_order_relaxed);
+        stats.solveNanos.fetch_add(static_cast<uint64_t>(seconds * 1e9), std::memory_order_relaxed);
+
+        size_t solveBucket = 0;
+        while (solveBucket < TELEMETRY_SOLVE_BUCKET_COUNT && seconds > TELEMETRY_SOLVE_BUCKETS[solveBucket]) {
+            ++solveBucket;
+        }
+        stats.solveBuckets[solveBucket].fetch_add(1, std::memory_order_relaxed);
+
+        size_t nonceBucket = 0;
+        for (uint64_t n = nonce > 0 ? static_cast<uint64_t>(nonce) : 1; n > 1; n >>= 1) {
+            ++nonceBucket;
+        }
+        stats.nonceBuckets[nonceBucket].fetch_add(1, std::memory_order_relaxed);
+        stats.nonceSum.fetch_add(static_cast<uint64_t>(nonce), std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(_logMutex);
+        _vBlockLog.push_back(BlockTiming{height, method, difficulty, nonce, hashes, seconds});
+    }
+
+    // --- Côté lecteur (n'importe quel thread) ---
+
+    uint64_t ThreadHashes(unsigned thread) const {
+        return _pThreads[thread].hashes.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Hash-rate d'un thread sur son temps de minage (minage en cours compris).
+     */
+    double ThreadHashRate(unsigned thread) const {
+        const ThreadSlot& slot = _pThreads[thread];
+        uint64_t busy = slot.busyNanos.load(std::memory_order_relaxed);
+        int64_t start = slot.startNanos.load(std::memory_order_relaxed);
+        if (start >= 0) {
+            busy += static_cast<uint64_t>(_NowNanos() - start);
+        }
+        return busy > 0 ? slot.hashes.load(std::memory_order_relaxed) * 1e9 / busy : 0.0;
+    }
+
+    uint64_t TotalHashes() const {
+        uint64_t total = 0;
+        for (unsigned t = 0; t < _nThreads; ++t) {
+            total += ThreadHashes(t);
+        }
+        return total;
+    }
+
+    uint64_t BlocksMined(HashMethod method, uint32_t difficulty) const {
+        return _Stats(method, difficulty).blocks.load(std::memory_order_relaxed);
+    }
+
+    std::vector<BlockTiming> BlockLog() const {
+        std::lock_guard<std::mutex> lock(_logMutex);
+        return _vBlockLog;
+    }
+
+    void WritePrometheus(std::ostream& os) const {
+        std::ios::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+        os << std::setprecision(9);
+
+        os << "# HELP miner_hashes_total Hashes tentes par thread de minage.\n"
+           << "# TYPE miner_hashes_total counter\n";
+        for (unsigned t = 0; t < _nThreads; ++t) {
+            os << "miner_hashes_total{thread=\"" << t << "\"} " << ThreadHashes(t) << "\n";
+        }
+        os << "# HELP miner_thread_hashrate Hashes par seconde de minage, par thread.\n"
+           << "# TYPE miner_thread_hashrate gauge\n";
+        for (unsigned t = 0; t < _nThreads; ++t) {
+            os << "miner_thread_hashrate{thread=\"" << t << "\"} " << ThreadHashRate(t) << "\n";
+        }
+
+        os << "# HELP miner_blocks_total Blocs mines par methode et difficulte.\n"
+           << "# TYPE miner_blocks_total counter\n";
+        for (size_t m = 0; m < TELEMETRY_METHODS; ++m) {
+            for (uint32_t d = 0; d <= TELEMETRY_MAX_DIFFICULTY; ++d) {
+                const DifficultyStats& s = _Stats(static_cast<HashMethod>(m), d);
+                if (s.blocks.load() > 0) {
+                    os << "miner_blocks_total{" << _Labels(static_cast<HashMethod>(m), d) << "} " << s.blocks.load() << "\n";
+                }
+            }
+        }
+
+        os << "# HELP miner_block_hashes_total Hashes necessaires aux blocs mines.\n"
+           << "# TYPE miner_block_hashes_total counter\n";
+        for (size_t m = 0; m < TELEMETRY_METHODS; ++m) {
+            for (uint32_t d = 0; d <= TELEMETRY_MAX_DIFFICULTY; ++d) {
+                const DifficultyStats& s = _Stats(static_cast<HashMethod>(m), d);
+                if (s.blocks.load() > 0) {
+                    os << "miner_block_hashes_total{" << _Labels(static_cast<HashMethod>(m), d) << "} " << s.hashes.load() << "\n";
+                }
+            }
+        }
+
+        os << "# HELP miner_solve_seconds Temps de resolution d'un bloc.\n"
+           << "# TYPE miner_solve_seconds histogram\n";
+        for (size_t m = 0; m < TELEMETRY_METHODS; ++m) {
+            for (uint32_t d = 0; d <= TELEMETRY_MAX_DIFFICULTY; ++d) {
+                const DifficultyStats& s = _Stats(static_cast<HashMethod>(m), d);
+                if (s.blocks.load() == 0) {
+                    continue;
+                }
+                const std::string labels = _Labels(static_cast<HashMethod>(m), d);
+                uint64_t cumulative = 0;
+                for (size_t b = 0; b <= TELEMETRY_SOLVE_BUCKET_COUNT; ++b) {
+                    cumulative += s.solveBuckets[b].load();
+                    os << "miner_solve_seconds_bucket{" << labels << ",le=\"";
+                    if (b < TELEMETRY_SOLVE_BUCKET_COUNT) {
+                        os << TELEMETRY_SOLVE_BUCKETS[b];
+                    } else {
+                        os << "+Inf";
+                    }
+                    os << "\"} " << cumulative << "\n";
+                }
+                os << "miner_solve_seconds_sum{" << labels << "} " << s.solveNanos.load() * 1e-9 << "\n"
+                   << "miner_solve_seconds_count{" << labels << "} " << s.blocks.load() << "\n";
+            }
+        }
+
+        os << "# HELP miner_winning_nonce Nonces gagnants (buckets en puissances de 2).\n"
+           << "# TYPE miner_winning_nonce histogram\n";
+        for (size_t m = 0; m < TELEMETRY_METHODS; ++m) {
+            for (uint32_t d = 0; d <= TELEMETRY_MAX_DIFFICULTY; ++d) {
+                const DifficultyStats& s = _Stats(static_cast<HashMethod>(m), d);
+                if (s.blocks.load() == 0) {
+                    continue;
+                }
+                const std::string labels = _Labels(static_cast<HashMethod>(m), d);
+                size_t last = 0;
+                for (size_t b = 0; b < TELEMETRY_NONCE_BUCKETS; ++b) {
+                    if (s.nonceBuckets[b].load() > 0) {
+                        last = b;
+                    }
+                }
+                uint64_t cumulative = 0;
+                for (size_t b = 0; b <= last; ++b) {
+                    cumulative += s.nonceBuckets[b].load();
+                    os << "miner_winning_nonce_bucket{" << labels << ",le=\"" << ((uint64_t(2) << b) - 1) << "\"} "
+                       << cumulative << "\n";
+                }
+                os << "miner_winning_nonce_bucket{" << labels << ",le=\"+Inf\"} " << cumulative << "\n"
+                   << "miner_winning_nonce_sum{" << labels << "} " << s.nonceSum.load() << "\n"
+                   << "miner_winning_nonce_count{" << labels << "} " << cumulative << "\n";
+            }
+        }
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+    bool WritePrometheusFile(const std::string& path) const {
+        std::ofstream file(path);
+        WritePrometheus(file);
+        return static_cast<bool>(file);
+    }
+
+    void WriteBlockLogCsv(std::ostream& os) const {
+        os << "height,method,difficulty,nonce,hashes,seconds\n";
+        for (const BlockTiming& b : BlockLog()) {
+            os << b.height << ',' << hash_method_name(b.method) << ',' << b.difficulty << ',' << b.nonce << ','
+               << b.hashes << ',' << b.seconds << '\n';
+        }
+    }
+};
+
+#endif // MINING_TELEMETRY_HPP
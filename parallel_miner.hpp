@@ -0,0 +1,188 @@
+#ifndef PARALLEL_MINER_HPP
+#define PARALLEL_MINER_HPP
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+
+#include "block_hash.hpp"
+#include "pow_target.hpp"
+#include "thread_pool.hpp"
+#include "mining_telemetry.hpp"
+
+/**
+ * Recherche de nonce multithread pour Block::MineBlock.
+ *
+ * Le worker 't' parmi 'T' teste les nonces first + t, first + t + T, ... dans
+ * l'ordre croissant. Dès qu'un worker trouve un nonce gagnant, il l'inscrit
+ * dans '_nBestNonce' (minimum atomique) ; chaque worker s'arrête quand son
+ * prochain nonce dépasse ce minimum. Tous les nonces plus petits ont donc été
+ * testés : le résultat est le plus petit nonce gagnant, le même qu'en
+ * séquentiel, quel que soit le nombre de threads.
+ */
+
+struct MinerThreadStats {
+    uint64_t hashes;
+    double seconds;
+
+    double HashRate() const {
+        return seconds > 0.0 ? static_cast<double>(hashes) / seconds : 0.0;
+    }
+};
+
+struct MineResult {
+    int64_t nonce;
+    Hash256 hash;
+    uint64_t totalHashes;
+    double seconds;
+    std::vector<MinerThreadStats> threads;
+
+    double HashRate() const {
+        return seconds > 0.0 ? static_cast<double>(totalHashes) / seconds : 0.0;
+    }
+};
+
+class ParallelMiner {
+private:
+    // Un compteur par ligne de cache pour éviter le faux partage entre workers.
+    struct alignas(64) ThreadCounter {
+        std::atomic<uint64_t> hashes;
+    };
+
+    ThreadPool& _pool;
+    std::unique_ptr<ThreadCounter[]> _pCounters;
+    std::atomic<int64_t> _nBestNonce;
+    MiningTelemetry* _pTelemetry; // nullptr : pas de télémétrie
+
+    // Les compteurs sont publiés tous les N hashes pour rester peu coûteux.
+    static const uint64_t COUNTER_PUBLISH_INTERVAL = 64;
+
+public:
+    /**
+     * @param pool Pool de threads partagé (minage, validation...) ; un worker
+     * par thread de minage.
+     */
+    explicit ParallelMiner(ThreadPool& pool)
+        : _pool(pool), _pCounters(new ThreadCounter[_pool.Size()]), _nBestNonce(0), _pTelemetry(nullptr) {
+        for (unsigned i = 0; i < _pool.Size(); ++i) {
+            _pCounters[i].hashes.store(0);
+        }
+    }
+
+    unsigned ThreadCount() const {
+        return _pool.Size();
+    }
+
+    /**
+     * @brief Publie les hashes et le temps de minage de chaque worker dans
+     * 'telemetry' (au moins ThreadCount() threads ; nullptr pour désactiver).
+     */
+    void SetTelemetry(MiningTelemetry* telemetry) {
+        if (telemetry != nullptr && telemetry->ThreadCount() < _pool.Size()) {
+            throw std::invalid_argument("ParallelMiner: la telemetrie a moins de slots que de threads de minage.");
+        }
+        _pTelemetry = telemetry;
+    }
+
+    /**
+     * @brief Hashes tentés par un worker pendant le minage en cours (lisible
+     * depuis un autre thread, pour suivre le hash-rate en direct).
+     */
+    uint64_t HashesDone(unsigned thread) const {
+        return _pCounters[thread].hashes.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Cherche le plus petit nonce >= firstNonce dont le hash respecte la difficulté.
+     * @param makeHasher Fabrique appelée une fois par worker ; elle retourne un
+     * objet 'hasher' (avec ses propres buffers) tel que hasher(nonce, hash)
+     * calcule le hash du bloc pour ce nonce.
+     */
+    template <class MakeHasher>
+    MineResult Mine(MakeHasher makeHasher, uint32_t nDifficulty, int64_t firstNonce = 1) {
+        return _Mine(makeHasher, [nDifficulty](const Hash256& hash) {
+            return hash_meets_difficulty(hash, nDifficulty);
+        }, firstNonce);
+    }
+
+    /**
+     * @brief Variante à cible 256 bits : hash <= target (voir pow_target.hpp).
+     */
+    template <class MakeHasher>
+    MineResult Mine(MakeHasher makeHasher, const Hash256& target, int64_t firstNonce = 1) {
+        return _Mine(makeHasher, [&target](const Hash256& hash) {
+            return hash_meets_target(hash, target);
+        }, firstNonce);
+    }
+
+private:
+    // accept(hash) : le hash respecte-t-il la difficulté ou la cible
+    template <class MakeHasher, class Accept>
+    MineResult _Mine(MakeHasher makeHasher, Accept accept, int64_t firstNonce) {
+        const unsigned nThreads = _pool.Size();
+        const int64_t noWinner = std::numeric_limits<int64_t>::max();
+        std::vector<MinerThreadStats> stats(nThreads);
+        std::vector<Hash256> winners(nThreads);
+
+        _nBestNonce.store(noWinner);
+        for (unsigned i = 0; i < nThreads; ++i) {
+            _pCounters[i].hashes.store(0, std::memory_order_relaxed);
+        }
+
+        auto t_start = std::chrono::steady_clock::now();
+
+        _pool.RunOnAll([&](unsigned t) {
+            auto hasher = makeHasher();
+            auto t_thread = std::chrono::steady_clock::now();
+            uint64_t nHashes = 0;
+            Hash256 hash;
+            if (_pTelemetry != nullptr) {
+                _pTelemetry->BeginMining(t);
+            }
+
+            for (int64_t nonce = firstNonce + t; nonce < _nBestNonce.load(std::memory_order_relaxed); nonce += nThreads) {
+                hasher(nonce, hash);
+                ++nHashes;
+                if (nHashes % COUNTER_PUBLISH_INTERVAL == 0) {
+                    _pCounters[t].hashes.store(nHashes, std::memory_order_relaxed);
+                    if (_pTelemetry != nullptr) {
+                        _pTelemetry->AddHashes(t, COUNTER_PUBLISH_INTERVAL);
+                    }
+                }
+
+                if (accept(hash)) {
+                    winners[t] = hash;
+                    int64_t best = _nBestNonce.load();
+                    while (nonce < best && !_nBestNonce.compare_exchange_weak(best, nonce)) {
+                    }
+                    break; // les nonces suivants de ce worker sont tous plus grands
+                }
+            }
+
+            _pCounters[t].hashes.store(nHashes, std::memory_order_relaxed);
+            if (_pTelemetry != nullptr) {
+                _pTelemetry->AddHashes(t, nHashes % COUNTER_PUBLISH_INTERVAL);
+                _pTelemetry->EndMining(t);
+            }
+            stats[t].hashes = nHashes;
+            stats[t].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_thread).count();
+        });
+
+        MineResult result;
+        result.nonce = _nBestNonce.load();
+        result.hash = winners[static_cast<uint64_t>(result.nonce - firstNonce) % nThreads];
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+        result.totalHashes = 0;
+        for (const auto& s : stats) {
+            result.totalHashes += s.hashes;
+        }
+        result.threads = stats;
+        return result;
+    }
+};
+
+#endif // PARALLEL_MINER_HPP
@@ -0,0 +1,245 @@
+#ifndef POW_TARGET_HPP
+#define POW_TARGET_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "block_hash.hpp"
+
+/**
+ * Cible de preuve de travail sur 256 bits et encodage compact "bits".
+ *
+ * La difficulté en nombre de zéros hexadécimaux ne bouge que par pas de 16x.
+ * Ici un hash est valide si, lu comme un entier big-endian de 256 bits, il
+ * est inférieur ou égal à la cible : le travail attendu se règle finement.
+ *
+ * Encodage compact (comme le champ nBits de Bitcoin) : octet de poids fort =
+ * taille de la cible en octets, 3 octets suivants = mantisse (bit 0x800000
+ * réservé au signe, toujours nul). cible = mantisse * 256^(taille - 3).
+ *
+ * DifficultyRetargeter ajuste la cible toutes les N blocs pour ramener le
+ * temps moyen par bloc vers l'intervalle configuré.
+ */
+
+// Cible la plus facile autorisée (~2^255) : un hash sur deux est valide
+const uint32_t POW_LIMIT_BITS = 0x207fffff;
+
+/**
+ * @brief Décode un "bits" compact en cible 256 bits (big-endian, comme Hash256).
+ */
+inline Hash256 target_from_compact(uint32_t nBits) {
+    const int size = static_cast<int>(nBits >> 24);
+    const uint32_t mantissa = nBits & 0x007fffff;
+    if ((nBits & 0x00800000) != 0 && mantissa != 0) {
+        throw std::invalid_argument("target_from_compact: cible negative.");
+    }
+
+    Hash256 target = Hash256();
+    for (int i = 0; i < 3; ++i) {
+        uint8_t byte = static_cast<uint8_t>(mantissa >> (8 * (2 - i)));
+        int pos = 32 - size + i;
+        if (pos < 0) {
+            if (byte != 0) {
+                throw std::invalid_argument("target_from_compact: cible superieure a 256 bits.");
+            }
+        } else if (pos < 32) {
+            target[pos] = byte;
+        }
+    }
+    return target;
+}
+
+/**
+ * @brief Encode une cible en "bits" compact (les octets au-delà des 3 de
+ * poids fort sont tronqués : la cible décodée est <= la cible d'origine).
+ */
+inline uint32_t target_to_compact(const Hash256& target) {
+    size_t first = 0;
+    while (first < target.size() && target[first] == 0) {
+        ++first;
+    }
+    uint32_t size = static_cast<uint32_t>(target.size() - first);
+    uint32_t mantissa = 0;
+    for (size_t i = first; i < first + 3; ++i) {
+        mantissa = (mantissa << 8) | (i < target.size() ? target[i] : 0);
+    }
+    if ((mantissa & 0x00800000) != 0) { // le bit de signe doit rester nul
+        mantissa >>= 8;
+        ++size;
+    }
+    return (size << 24) | mantissa;
+}
+
+inline bool hash_meets_target(const Hash256& hash, const Hash256& target) {
+    return std::memcmp(hash.data(), target.data(), hash.size()) <= 0;
+}
+
+/**
+ * @brief "bits" équivalent à l'ancienne difficulté : les 'nDifficulty'
+ * premiers chiffres hexadécimaux nuls (cible = 16^(64 - n) - 1, tronquée).
+ */
+inline uint32_t compact_from_difficulty(uint32_t nDifficulty) {
+    if (nDifficulty > 63) {
+        throw std::invalid_argument("compact_from_difficulty: difficulte trop grande.");
+    }
+    Hash256 target;
+    target.fill(0xff);
+    for (uint32_t i = 0; i < nDifficulty / 2; ++i) {
+        target[i] = 0;
+    }
+    if (nDifficulty & 1) {
+        target[nDifficulty / 2] = 0x0f;
+    }
+    return target_to_compact(target);
+}
+
+/**
+ * @brief Nombre de zéros hexadécimaux en tête de la cible : la difficulté
+ * entière la plus proche par défaut (étiquette de télémétrie).
+ */
+inline uint32_t target_leading_zero_digits(const Hash256& target) {
+    uint32_t digits = 0;
+    for (uint8_t byte : target) {
+        if (byte != 0) {
+            return digits + ((byte >> 4) == 0 ? 1 : 0);
+        }
+        digits += 2;
+    }
+    return digits;
+}
+
+/**
+ * @brief Nombre moyen de hashes pour trouver un bloc : 2^256 / (cible + 1).
+ */
+inline double target_expected_hashes(const Hash256& target) {
+    double value = 0.0;
+    for (uint8_t byte : target) {
+        value = value * 256.0 + byte;
+    }
+    return std::ldexp(1.0, 256) / (value + 1.0);
+}
+
+/**
+ * @brief cible * num / den sur 256 bits (mots de 32 bits) ; un dépassement
+ * donne la cible maximale 2^256 - 1.
+ */
+inline Hash256 target_scale(const Hash256& target, uint32_t num, uint32_t den) {
+    if (den == 0) {
+        throw std::invalid_argument("target_scale: denominateur nul.");
+    }
+    uint32_t limbs[9] = {0}; // poids faible d'abord ; limbs[8] reçoit la retenue
+    for (int i = 0; i < 8; ++i) {
+        const uint8_t* p = target.data() + 28 - 4 * i;
+        limbs[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    }
+
+    uint64_t carry = 0;
+    for (int i = 0; i < 9; ++i) {
+        uint64_t product = uint64_t(limbs[i]) * num + carry;
+        limbs[i] = static_cast<uint32_t>(product);
+        carry = product >> 32;
+    }
+    uint64_t remainder = 0;
+    for (int i = 8; i >= 0; --i) {
+        uint64_t current = (remainder << 32) | limbs[i];
+        limbs[i] = static_cast<uint32_t>(current / den);
+        remainder = current % den;
+    }
+
+    Hash256 result;
+    if (limbs[8] != 0) {
+        result.fill(0xff);
+        return result;
+    }
+    for (int i = 0; i < 8; ++i) {
+        uint8_t* p = result.data() + 28 - 4 * i;
+        p[0] = static_cast<uint8_t>(limbs[i] >> 24);
+        p[1] = static_cast<uint8_t>(limbs[i] >> 16);
+        p[2] = static_cast<uint8_t>(limbs[i] >> 8);
+        p[3] = static_cast<uint8_t>(limbs[i]);
+    }
+    return result;
+}
+
+struct RetargetParams {
+    uint32_t interval;         // blocs par fenêtre d'ajustement
+    double targetBlockSeconds; // temps visé par bloc
+    double maxAdjustFactor;    // variation maximale de la cible par fenêtre (4 dans Bitcoin)
+    uint32_t limitBits;        // cible la plus facile autorisée
+};
+
+const RetargetParams RETARGET_DEFAULT_PARAMS = {16, 0.05, 4.0, POW_LIMIT_BITS};
+
+/**
+ * @class DifficultyRetargeter
+ * Toutes les 'interval' blocs : cible *= temps observé / temps visé, borné
+ * à [1/maxAdjustFactor, maxAdjustFactor] et à la cible limite. Les durées
+ * viennent du mineur (MineResult::seconds) : l'horodatage des blocs est à la
+ * seconde, trop grossier pour des blocs de quelques millisecondes.
+ * La cible courante est toujours celle décodée de Bits().
+ */
+class DifficultyRetargeter {
+private:
+    RetargetParams _params;
+    Hash256 _limit;
+    uint32_t _nBits;
+    Hash256 _target;
+    uint32_t _nWindowBlocks;
+    double _dWindowSeconds;
+    double _dLastWindowAverage; // temps moyen par bloc de la dernière fenêtre close
+
+    // Précision du facteur d'ajustement (virgule fixe)
+    static const uint32_t RATIO_ONE = 1u << 20;
+
+    void _SetTarget(const Hash256& target) {
+        _nBits = target_to_compact(std::min(target, _limit));
+        _target = target_from_compact(_nBits);
+    }
+
+public:
+    DifficultyRetargeter(const RetargetParams& params, uint32_t initialBits)
+        : _params(params), _limit(target_from_compact(params.limitBits)), _nBits(0), _target(),
+          _nWindowBlocks(0), _dWindowSeconds(0.0), _dLastWindowAverage(0.0) {
+        if (params.interval == 0 || !(params.targetBlockSeconds > 0.0) || !(params.maxAdjustFactor >= 1.0)) {
+            throw std::invalid_argument("DifficultyRetargeter: parametres invalides.");
+        }
+        _SetTarget(target_from_compact(initialBits));
+    }
+
+    uint32_t Bits() const {
+        return _nBits;
+    }
+
+    const Hash256& Target() const {
+        return _target;
+    }
+
+    double LastWindowAverage() const {
+        return _dLastWindowAverage;
+    }
+
+    /**
+     * @brief Enregistre la durée de minage d'un bloc ; retourne true si la
+     * fenêtre est close et la cible recalculée.
+     */
+    bool RecordBlock(double seconds) {
+        _dWindowSeconds += seconds;
+        if (++_nWindowBlocks < _params.interval) {
+            return false;
+        }
+
+        _dLastWindowAverage = _dWindowSeconds / _params.interval;
+        double ratio = _dLastWindowAverage / _params.targetBlockSeconds;
+        ratio = std::max(1.0 / _params.maxAdjustFactor, std::min(ratio, _params.maxAdjustFactor));
+        _SetTarget(target_scale(_target, static_cast<uint32_t>(std::lround(ratio * RATIO_ONE)), RATIO_ONE));
+
+        _nWindowBlocks = 0;
+        _dWindowSeconds = 0.0;
+        return true;
+    }
+};
+
+#endif // POW_TARGET_HPP
@@ -6,28 +6,31 @@
 #include <numeric> 
 #include <random>
 #include <stdexcept>
+#include <cmath>
 #include <sstream>
+#include <fstream>
 #include <iomanip> // Pour std::setw, std::setprecision, std::fixed
+#include <thread>  // Pour std::thread (minage, test de concurrence)
+#include <atomic>
+#include <memory>  // Pour std::unique_ptr (ajustement de difficulté)
+#include <cstring> // Pour std::memcmp
+#include <cstdio>  // Pour std::snprintf (cible dans la préimage)
 
 // --- 1. Inclusions des fichiers HPP ---
 // (Au lieu de coller le code)
 #include "sha256.hpp"
 #include "ac_hash.hpp"
+#include "block_hash.hpp" // HashMethod + hashes binaires
+#include "parallel_miner.hpp" // Recherche de nonce multithread
+#include "block_header.hpp"   // En-tête binaire à taille fixe
+#include "chain_validation.hpp" // Validation parallèle de la chaîne
+#include "validator_registry.hpp" // Sélection PoS pondérée en O(log n)
+#include "merkle.hpp"         // Racine de Merkle des données
+#include "mining_telemetry.hpp" // Compteurs de minage + export Prometheus
+#include "pow_target.hpp"   // Cible 256 bits "bits" + ajustement de difficulté
 // ------------------------------------
 
 
-// --- Enum et Structs ---
-enum class HashMethod {
-    SHA256,
-    AC_HASH
-};
-struct Validator {
-    std::string address;
-    double stake;
-};
-// --- FIN Enum et Structs ---
-
-
 // --- Classe Block (modifiée pour Q4) ---
 class Block {
 private:
@@ -37,47 +40,116 @@ private:
     std::string _sValidatorAddress; 
     int64_t _nNonce;                
     HashMethod _hMethod;            
+    BlockFormat _eFormat;
+    Hash256 _dataHash;      // BINARY_HEADER : racine de Merkle de _sData, calculée une fois
+    uint32_t _nValidatorId; // BINARY_HEADER : 0 en PoW
+    uint32_t _nBits;        // cible compacte du minage (0 : difficulté fixe en zéros hexadécimaux)
+
+    // La cible est engagée dans la préimage : 8 chiffres hexadécimaux (largeur
+    // fixe, pas d'ambiguïté avec le nonce), absents en difficulté fixe
+    std::string _BasePreimage() const {
+        std::string preimage = std::to_string(_nIndex) + std::to_string(_tTime) + _sData +
+                               prev_hash_preimage(_nIndex, prevHash);
+        if (_nBits != 0) {
+            char bits[9];
+            std::snprintf(bits, sizeof(bits), "%08x", _nBits);
+            preimage += bits;
+        }
+        return preimage;
+    }
+
+    BlockHeader _Header() const {
+        return BlockHeader{_nIndex, static_cast<int64_t>(_tTime), prevHash, _dataHash,
+                           _nValidatorId, _nBits, static_cast<uint64_t>(_nNonce)};
+    }
 
-    std::string _CalculateHashPoS() const {
-        std::string ss = std::to_string(_nIndex) + std::to_string(_tTime) + _sData + sPrevHash + _sValidatorAddress;
-        switch(_hMethod) {
-            case HashMethod::AC_HASH: return ac_hash(ss, 30, 128); 
-            case HashMethod::SHA256: default: return sha256(ss);
+    Hash256 _CalculateHashPoS() const {
+        if (_eFormat == BlockFormat::BINARY_HEADER) {
+            return _Header().Hash(_hMethod);
         }
+        return compute_hash_raw(_hMethod, _BasePreimage() + _sValidatorAddress);
     }
 
-public:
-    std::string sPrevHash;
-    std::string sHash;
+    template <class Hasher>
+    void _MineSequential(Hasher hasher, uint32_t nDifficulty) {
+        _nNonce = 0; 
+        do {
+            _nNonce++;
+            hasher(_nNonce, hash);
+        } while (!hash_meets_difficulty(hash, nDifficulty));
+    }
 
-    Block(uint32_t nIndexIn, const std::string &sDataIn, HashMethod method) 
-        : _nIndex(nIndexIn), _sData(sDataIn), _tTime(time(nullptr)), _nNonce(0), _hMethod(method) {
+public:
+    Hash256 prevHash;
+    Hash256 hash;
+
+    Block(uint32_t nIndexIn, const std::string &sDataIn, HashMethod method,
+          BlockFormat format = BlockFormat::LEGACY_STRING) 
+        : _nIndex(nIndexIn), _sData(sDataIn), _tTime(time(nullptr)), _nNonce(0), _hMethod(method),
+          _eFormat(format), _dataHash(), _nValidatorId(0), _nBits(0), prevHash(), hash() {
+        if (_eFormat == BlockFormat::BINARY_HEADER) {
+            _dataHash = merkle_leaf_hash(_hMethod, _sData);
+        }
     }
 
-    void ValidateBlock(const std::string& validatorAddress) {
+    void ValidateBlock(const std::string& validatorAddress, uint32_t validatorId = 0) {
         _sValidatorAddress = validatorAddress;
-        sHash = _CalculateHashPoS();
+        _nValidatorId = validatorId;
+        hash = _CalculateHashPoS();
     }
 
     void MineBlock(uint32_t nDifficulty) {
-        std::string str(nDifficulty, '0');
-        _nNonce = 0; 
-        do {
-            _nNonce++;
-            std::string ss = std::to_string(_nIndex) + std::to_string(_tTime) + _sData + sPrevHash + std::to_string(_nNonce);
-            switch(_hMethod) {
-                case HashMethod::AC_HASH: sHash = ac_hash(ss, 30, 128); break;
-                case HashMethod::SHA256: default: sHash = sha256(ss); break;
-            }
-        } while (sHash.substr(0, nDifficulty) != str);
+        // Buffer préalloué : seul le nonce est réécrit, sans allocation ni hexadécimal
+        if (_eFormat == BlockFormat::BINARY_HEADER) {
+            _MineSequential(HeaderNonceHasher(_hMethod, _Header()), nDifficulty);
+        } else {
+            _MineSequential(NonceHasher(_hMethod, _BasePreimage()), nDifficulty);
+        }
+    }
+
+    // Variante multithread (même nonce que la version séquentielle)
+    MineResult MineBlock(uint32_t nDifficulty, ParallelMiner& miner) {
+        const HashMethod method = _hMethod;
+        MineResult result;
+        if (_eFormat == BlockFormat::BINARY_HEADER) {
+            const BlockHeader header = _Header();
+            result = miner.Mine([&] { return HeaderNonceHasher(method, header); }, nDifficulty);
+        } else {
+            const std::string base = _BasePreimage();
+            result = miner.Mine([&] { return NonceHasher(method, base); }, nDifficulty);
+        }
+        _nNonce = result.nonce;
+        hash = result.hash;
+        return result;
+    }
+
+    // Minage contre une cible 256 bits : hash <= target_from_compact(nBits)
+    MineResult MineBlockTarget(uint32_t nBits, ParallelMiner& miner) {
+        const HashMethod method = _hMethod;
+        const Hash256 target = target_from_compact(nBits);
+        _nBits = nBits; // avant la préimage : la cible fait partie du hash
+        MineResult result;
+        if (_eFormat == BlockFormat::BINARY_HEADER) {
+            const BlockHeader header = _Header();
+            result = miner.Mine([&] { return HeaderNonceHasher(method, header); }, target);
+        } else {
+            const std::string base = _BasePreimage();
+            result = miner.Mine([&] { return NonceHasher(method, base); }, target);
+        }
+        _nNonce = result.nonce;
+        hash = result.hash;
+        return result;
     }
 
-    std::string recalculatePoWHash() const {
-        std::string ss = std::to_string(_nIndex) + std::to_string(_tTime) + _sData + sPrevHash + std::to_string(_nNonce);
-        switch(_hMethod) {
-            case HashMethod::AC_HASH: return ac_hash(ss, 30, 128);
-            case HashMethod::SHA256: default: return sha256(ss);
+    Hash256 recalculatePoWHash() const {
+        if (_eFormat == BlockFormat::BINARY_HEADER) {
+            return _Header().Hash(_hMethod);
         }
+        return compute_hash_raw(_hMethod, _BasePreimage() + std::to_string(_nNonce));
+    }
+
+    std::string GetHashHex() const {
+        return hash_to_hex(hash);
     }
 
     // --- AJOUT POUR Q4.2 ---
@@ -88,6 +160,12 @@ public:
         return _nNonce;
     }
     // --- FIN AJOUT Q4.2 ---
+
+    uint32_t GetBits() const {
+        return _nBits;
+    }
+
+    friend bool verify_target_commitment();
 };
 
 
@@ -95,46 +173,76 @@ public:
 class Blockchain {
 private:
     std::vector<Block> _vChain;
-    std::vector<Validator> _vValidators;
+    ValidatorRegistry _validators; // Validateurs PoS + générateur aléatoire
     HashMethod _hMethod; 
+    BlockFormat _eFormat;
+    mutable ThreadPool _pool; // Threads partagés par le minage et la validation
+    ParallelMiner _miner;
+    MiningTelemetry* _pTelemetry; // nullptr : pas de télémétrie
+    bool _bVerbose;               // une ligne par bloc miné
+    std::unique_ptr<DifficultyRetargeter> _pRetargeter; // nullptr : difficulté fixe
 
     const Block& _GetLastBlock() const {
         return _vChain.back();
     }
 
-    Validator& SelectValidator() {
-        double totalStake = 0.0;
-        for (const auto& v : _vValidators) { totalStake += v.stake; }
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> distrib(0, totalStake);
-        double randomPoint = distrib(gen);
-        double currentSum = 0.0;
-        for (auto& v : _vValidators) {
-            currentSum += v.stake;
-            if (randomPoint <= currentSum) { return v; }
-        }
-        return _vValidators.back();
+public:
+    // nMiningThreads = 0 : un thread de minage par coeur
+    Blockchain(HashMethod method, BlockFormat format = BlockFormat::LEGACY_STRING, unsigned nMiningThreads = 0)
+        : _hMethod(method), _eFormat(format), _pool(nMiningThreads), _miner(_pool), _pTelemetry(nullptr),
+          _bVerbose(true) {
+        Block genesisBlock(0, "Genesis Block", _hMethod, _eFormat);
+        genesisBlock.MineBlock(1, _miner); // Mine le bloc Genesis avec difficulte 1
+        _vChain.push_back(std::move(genesisBlock));
     }
 
-public:
-    Blockchain(HashMethod method) : _hMethod(method) {
-        Block genesisBlock(0, "Genesis Block", _hMethod);
-        genesisBlock.MineBlock(1); // Mine le bloc Genesis avec difficulte 1
-        _vChain.push_back(genesisBlock);
+    /**
+     * @brief Branche la télémétrie (partageable entre chaînes, au moins un
+     * slot par thread de minage) ; les blocs suivants y sont enregistrés.
+     */
+    void SetTelemetry(MiningTelemetry* telemetry) {
+        _miner.SetTelemetry(telemetry); // lève std::invalid_argument si trop peu de slots
+        _pTelemetry = telemetry;
+    }
+
+    void SetVerbose(bool bVerbose) {
+        _bVerbose = bVerbose;
+    }
+
+    unsigned MiningThreads() const {
+        return _miner.ThreadCount();
+    }
+
+    /**
+     * @brief Active la cible ajustable pour AddBlockPoWTarget() : part de
+     * 'initialBits' et se recale toutes les params.interval blocs.
+     */
+    void EnableRetargeting(const RetargetParams& params, uint32_t initialBits) {
+        _pRetargeter.reset(new DifficultyRetargeter(params, initialBits));
+    }
+
+    const DifficultyRetargeter& Retargeter() const {
+        if (!_pRetargeter) {
+            throw std::logic_error("Blockchain: ajustement de difficulte non active.");
+        }
+        return *_pRetargeter;
     }
 
     void AddValidator(const std::string& address, double stake) {
-        _vValidators.push_back({address, stake});
+        _validators.Add(address, stake);
+    }
+
+    void SeedValidatorSelection(uint64_t seed) {
+        _validators.Seed(seed);
     }
 
     void AddBlockPoS(const std::string& sData) {
-        if (_vValidators.empty()) { return; }
-        Block bNew(_vChain.size(), sData, _hMethod); 
-        Validator& chosenValidator = SelectValidator();
-        bNew.sPrevHash = _GetLastBlock().sHash;
-        bNew.ValidateBlock(chosenValidator.address);
-        _vChain.push_back(bNew);
+        if (_validators.Empty()) { return; }
+        Block bNew(_vChain.size(), sData, _hMethod, _eFormat); 
+        size_t chosenIndex = _validators.SelectIndex();
+        bNew.prevHash = _GetLastBlock().hash;
+        bNew.ValidateBlock(_validators[chosenIndex].address, static_cast<uint32_t>(chosenIndex) + 1);
+        _vChain.push_back(std::move(bNew));
     }
 
     // --- MODIFIÉ POUR Q4.1 et Q4.2 ---
@@ -142,47 +250,527 @@ public:
      * @brief Ajoute un bloc PoW et retourne le nombre d'itérations (nonce) utilisées.
      */
     int64_t AddBlockPoW(const std::string& sData, uint32_t difficulty) {
-        Block bNew(_vChain.size(), sData, _hMethod);
-        bNew.sPrevHash = _GetLastBlock().sHash;
+        Block bNew(_vChain.size(), sData, _hMethod, _eFormat);
+        bNew.prevHash = _GetLastBlock().hash;
         
-        std::string methodName = (_hMethod == HashMethod::AC_HASH ? "AC_HASH" : "SHA256");
-        std::cout << "Minage bloc " << _vChain.size() << " (" << methodName << ")... ";
+        std::string methodName = hash_method_name(_hMethod);
+        if (_bVerbose) {
+            std::cout << "Minage bloc " << _vChain.size() << " (" << methodName << ")... ";
+        }
 
-        bNew.MineBlock(difficulty); 
+        MineResult result = bNew.MineBlock(difficulty, _miner); 
         
-        std::cout << "OK (Nonce=" << bNew.getNonce() << ")" << std::endl;
-        _vChain.push_back(bNew);
+        if (_bVerbose) {
+            std::cout << "OK (Nonce=" << bNew.getNonce() << ", "
+                      << static_cast<uint64_t>(result.HashRate()) << " H/s)" << std::endl;
+        }
+        if (_pTelemetry != nullptr) {
+            _pTelemetry->RecordBlock(_vChain.size(), _hMethod, difficulty, result.nonce,
+                                     result.totalHashes, result.seconds);
+        }
+        int64_t nonce = bNew.getNonce();
+        _vChain.push_back(std::move(bNew));
         
         // Retourne le nombre d'itérations
-        return bNew.getNonce();
+        return nonce;
     }
     // --- FIN MODIFICATION Q4 ---
 
+    /**
+     * @brief Ajoute un bloc PoW miné contre la cible courante du
+     * DifficultyRetargeter (voir EnableRetargeting) ; retourne sa durée de minage.
+     */
+    double AddBlockPoWTarget(const std::string& sData) {
+        if (!_pRetargeter) {
+            throw std::logic_error("Blockchain: ajustement de difficulte non active.");
+        }
+        Block bNew(_vChain.size(), sData, _hMethod, _eFormat);
+        bNew.prevHash = _GetLastBlock().hash;
+
+        const uint32_t nBits = _pRetargeter->Bits();
+        MineResult result = bNew.MineBlockTarget(nBits, _miner);
+
+        if (_bVerbose) {
+            std::cout << "Minage bloc " << _vChain.size() << " (" << hash_method_name(_hMethod) << ", bits=0x"
+                      << std::hex << nBits << std::dec << ")... OK (Nonce=" << bNew.getNonce() << ")" << std::endl;
+        }
+        if (_pTelemetry != nullptr) {
+            _pTelemetry->RecordBlock(_vChain.size(), _hMethod, target_leading_zero_digits(_pRetargeter->Target()),
+                                     result.nonce, result.totalHashes, result.seconds);
+        }
+        _pRetargeter->RecordBlock(result.seconds);
+        _vChain.push_back(std::move(bNew));
+        return result.seconds;
+    }
+
+
+    // Validation parallèle, avec le premier bloc fautif et la raison
+    ValidationResult ValidateChainPoW() const {
+        return validate_chain_pow(_vChain, _pool);
+    }
 
     bool isChainValidPoW() const {
-        for (size_t i = 1; i < _vChain.size(); ++i) {
-            const Block& currentBlock = _vChain[i];
-            const Block& previousBlock = _vChain[i - 1];
-            if (currentBlock.sHash != currentBlock.recalculatePoWHash()) {
-                return false;
+        return ValidateChainPoW().valid;
+    }
+};
+
+
+// --- Test de concurrence de SHA256 ---
+/**
+ * @brief Message de test : longueurs variées pour couvrir 1, 2 et 3 blocs.
+ */
+std::string stress_message(size_t i) {
+    return "stress_" + std::to_string(i) + std::string(i % 150, 'x');
+}
+
+/**
+ * @brief Hache depuis plusieurs threads en même temps et vérifie chaque résultat
+ * contre un calcul séquentiel. Chaque thread réutilise un seul contexte SHA256
+ * (reset()) et écrit dans son propre buffer (digest(out)).
+ */
+bool verify_concurrent_sha256(unsigned num_threads, size_t hashes_per_thread) {
+    const size_t total = num_threads * hashes_per_thread;
+    std::vector<std::array<uint8_t, 32>> expected(total);
+    for (size_t i = 0; i < total; ++i) {
+        expected[i] = sha256_raw(stress_message(i));
+    }
+
+    std::atomic<size_t> errors(0);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            SHA256 sha;
+            uint8_t out[32];
+            for (size_t j = 0; j < hashes_per_thread; ++j) {
+                size_t i = t * hashes_per_thread + j;
+                sha.reset();
+                sha.update(stress_message(i));
+                sha.digest(out);
+                if (std::memcmp(out, expected[i].data(), sizeof(out)) != 0) {
+                    errors++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::cout << total << " hashes sur " << num_threads << " threads, "
+              << errors.load() << " erreur(s)" << std::endl;
+    return errors.load() == 0;
+}
+
+/**
+ * @brief Chaque backend SHA256 disponible (sha256_batch) donne les mêmes
+ * octets que le code scalaire : longueurs 0 à 130 (frontières de blocs et de
+ * remplissage) et vecteurs NIST ("", "abc", un million de 'a').
+ */
+bool verify_sha256_backends() {
+    struct NistVector {
+        std::string message;
+        const char* hex;
+    };
+    const NistVector nist[] = {
+        {"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+        {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+        {std::string(1000000, 'a'), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"},
+    };
+
+    std::vector<std::string> inputs;
+    for (size_t len = 0; len <= 130; ++len) {
+        std::string message(len, '\0');
+        for (size_t i = 0; i < len; ++i) {
+            message[i] = static_cast<char>(i * 131 + len * 7 + 1);
+        }
+        inputs.push_back(message);
+    }
+    for (const NistVector& v : nist) {
+        inputs.push_back(v.message);
+    }
+
+    std::vector<std::array<uint8_t, 32>> reference(inputs.size());
+    sha256_batch(inputs.data(), inputs.size(), reinterpret_cast<uint8_t (*)[32]>(reference.data()),
+                 Sha256Backend::SCALAR);
+    for (size_t i = 0; i < 3; ++i) {
+        if (bytes_to_hex_string(reference[131 + i].data(), 32) != nist[i].hex) {
+            std::cout << "Scalaire : vecteur NIST " << i << " incorrect" << std::endl;
+            return false;
+        }
+    }
+
+    bool bOk = true;
+    for (Sha256Backend backend : {Sha256Backend::SHANI, Sha256Backend::AVX2_X8}) {
+        if (!sha256_backend_supported(backend)) {
+            std::cout << sha256_backend_name(backend) << " : non disponible sur ce CPU" << std::endl;
+            continue;
+        }
+        std::vector<std::array<uint8_t, 32>> digests(inputs.size());
+        sha256_batch(inputs.data(), inputs.size(), reinterpret_cast<uint8_t (*)[32]>(digests.data()), backend);
+        size_t nMismatches = 0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            nMismatches += (digests[i] != reference[i]) ? 1 : 0;
+        }
+        std::cout << sha256_backend_name(backend) << " : " << inputs.size() << " messages, "
+                  << nMismatches << " difference(s) avec SCALAR" << std::endl;
+        bOk = bOk && nMismatches == 0;
+    }
+    return bOk;
+}
+
+/**
+ * @brief NonceHasher (midstate SHA256, buffer réécrit pour AC_HASH) donne le
+ * hash de la préimage complète base + nonce : bases de part et d'autre des
+ * frontières de 55 et 64 octets (remplissage SHA256), nonces de 1 à 19 chiffres.
+ */
+bool verify_nonce_hasher() {
+    std::vector<size_t> baseLengths;
+    for (size_t len = 0; len <= 8; ++len) {
+        baseLengths.push_back(len);
+    }
+    for (size_t len = 40; len <= 72; ++len) {
+        baseLengths.push_back(len);
+    }
+    for (size_t len = 110; len <= 130; ++len) {
+        baseLengths.push_back(len);
+    }
+    std::vector<int64_t> nonces;
+    for (int64_t nonce = 1; nonce <= 100; ++nonce) {
+        nonces.push_back(nonce);
+    }
+    for (int64_t nonce : {INT64_C(999), INT64_C(1000), INT64_C(123456789), INT64_C(9999999999),
+                          INT64_C(1000000000000000000), INT64_MAX}) {
+        nonces.push_back(nonce);
+    }
+
+    size_t nChecked = 0;
+    size_t nMismatches = 0;
+    for (HashMethod method : {HashMethod::SHA256, HashMethod::AC_HASH}) {
+        for (size_t len : baseLengths) {
+            std::string base(len, '\0');
+            for (size_t i = 0; i < len; ++i) {
+                base[i] = static_cast<char>('a' + (i * 7 + len) % 26);
+            }
+            NonceHasher hasher(method, base);
+            for (int64_t nonce : nonces) {
+                Hash256 hash;
+                hasher(nonce, hash);
+                nMismatches += (hash != compute_hash_raw(method, base + std::to_string(nonce))) ? 1 : 0;
+                ++nChecked;
+            }
+        }
+    }
+    std::cout << nChecked << " couples (base, nonce) verifies, " << nMismatches << " difference(s)" << std::endl;
+    return nMismatches == 0;
+}
+// --- FIN Test de concurrence ---
+
+
+// --- Charge soutenue avec télémétrie ---
+/**
+ * @brief Mine des blocs (en-tête binaire) pendant 'seconds' secondes avec
+ * chaque méthode, pendant qu'un autre thread lit la télémétrie en direct.
+ * La télémétrie est ensuite exportée (Prometheus + journal CSV des blocs).
+ */
+void run_sustained_mining(uint32_t difficulty, double seconds) {
+    MiningTelemetry telemetry(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1);
+
+    std::atomic<bool> bDone(false);
+    std::thread reader([&] {
+        while (!bDone.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            double rate = 0.0;
+            for (unsigned t = 0; t < telemetry.ThreadCount(); ++t) {
+                rate += telemetry.ThreadHashRate(t);
+            }
+            std::cout << "  [direct] " << telemetry.TotalHashes() << " hashes, "
+                      << static_cast<uint64_t>(rate) << " H/s" << std::endl;
+        }
+    });
+
+    for (HashMethod method : {HashMethod::SHA256, HashMethod::AC_HASH}) {
+        Blockchain chain(method, BlockFormat::BINARY_HEADER);
+        chain.SetVerbose(false);
+        chain.SetTelemetry(&telemetry);
+        auto t_start = std::chrono::steady_clock::now();
+        while (std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count() < seconds) {
+            chain.AddBlockPoW("Charge soutenue", difficulty);
+        }
+    }
+    bDone.store(true);
+    reader.join();
+
+    std::cout << std::fixed << std::setprecision(4);
+    for (HashMethod method : {HashMethod::SHA256, HashMethod::AC_HASH}) {
+        uint64_t nBlocks = 0, nHashes = 0;
+        double totalSeconds = 0.0;
+        for (const BlockTiming& b : telemetry.BlockLog()) {
+            if (b.method == method) {
+                ++nBlocks;
+                nHashes += b.hashes;
+                totalSeconds += b.seconds;
+            }
+        }
+        std::cout << hash_method_name(method) << " : " << nBlocks << " blocs, "
+                  << (nBlocks ? totalSeconds / nBlocks : 0.0) << " s/bloc, "
+                  << static_cast<uint64_t>(totalSeconds > 0 ? nHashes / totalSeconds : 0) << " H/s" << std::endl;
+    }
+
+    telemetry.WritePrometheusFile("q4_mining_metrics.prom");
+    std::ofstream csv("q4_mining_blocks.csv");
+    telemetry.WriteBlockLogCsv(csv);
+    std::cout << "Telemetrie exportee : q4_mining_metrics.prom, q4_mining_blocks.csv" << std::endl;
+}
+// --- FIN Charge soutenue ---
+
+
+// --- Cible 256 bits et ajustement de difficulté ---
+/**
+ * @brief Aller-retour de l'encodage compact, et équivalence entre l'ancienne
+ * difficulté (zéros hexadécimaux) et la cible compact_from_difficulty().
+ */
+bool verify_compact_target() {
+    for (uint32_t nBits : {0x1d00ffffu, 0x207fffffu, 0x1b0404cbu, 0x03123456u, 0x01120000u}) {
+        if (target_to_compact(target_from_compact(nBits)) != nBits) {
+            std::cout << "Aller-retour compact incorrect pour 0x" << std::hex << nBits << std::dec << std::endl;
+            return false;
+        }
+    }
+    std::mt19937_64 rng(19);
+    for (uint32_t difficulty = 0; difficulty <= 8; ++difficulty) {
+        const Hash256 target = target_from_compact(compact_from_difficulty(difficulty));
+        for (int i = 0; i < 20000; ++i) {
+            Hash256 hash;
+            for (uint8_t& byte : hash) {
+                byte = static_cast<uint8_t>(rng());
+            }
+            // Les premiers octets sont souvent nuls, pour tester la frontière
+            for (uint32_t z = 0; z < (rng() % (difficulty / 2 + 2)) && z < hash.size(); ++z) {
+                hash[z] = 0;
             }
-            if (currentBlock.sPrevHash != previousBlock.sHash) {
+            if ((difficulty & 1) && (rng() & 1)) {
+                hash[difficulty / 2] &= 0x0f;
+            }
+            // La cible compacte ne garde que 3 octets : les hashes dans la partie tronquée sont rejetés
+            bool bTruncated = hash_meets_difficulty(hash, difficulty) &&
+                              std::memcmp(hash.data(), target.data(), hash.size()) > 0;
+            if (!bTruncated && hash_meets_target(hash, target) != hash_meets_difficulty(hash, difficulty)) {
+                std::cout << "Cible et difficulte " << difficulty << " divergent" << std::endl;
                 return false;
             }
         }
-        return true;
     }
-};
+    return true;
+}
+
+/**
+ * @brief Règles du DifficultyRetargeter sur des durées synthétiques (aucune
+ * horloge) : fenêtre de 'interval' blocs, cible *= temps observé / temps
+ * visé, facteur borné, cible limite, puis convergence d'un mineur simulé à
+ * débit constant.
+ */
+bool verify_retarget_rules() {
+    const RetargetParams& params = RETARGET_DEFAULT_PARAMS;
+    const double target = params.targetBlockSeconds;
+    DifficultyRetargeter retargeter(params, compact_from_difficulty(4));
+
+    // Enregistre une fenêtre de blocs de 'seconds' et compare à la cible * num / den attendue
+    auto window = [&](double seconds, uint32_t num, uint32_t den) {
+        const Hash256 expected = target_from_compact(target_to_compact(target_scale(retargeter.Target(), num, den)));
+        const uint32_t bitsBefore = retargeter.Bits();
+        for (uint32_t i = 0; i + 1 < params.interval; ++i) {
+            if (retargeter.RecordBlock(seconds) || retargeter.Bits() != bitsBefore) {
+                return false; // la cible ne change qu'en fin de fenêtre
+            }
+        }
+        return retargeter.RecordBlock(seconds) && retargeter.Target() == expected &&
+               std::fabs(retargeter.LastWindowAverage() - seconds) < 1e-12;
+    };
+
+    bool bOk = window(2 * target, 2, 1)          // blocs deux fois trop lents : cible doublée
+            && window(target / 2, 1, 2)          // deux fois trop rapides : cible divisée par deux
+            && window(target, 1, 1)              // à l'heure : inchangée
+            && window(100 * target, 4, 1)        // borné à maxAdjustFactor
+            && window(0.0, 1, 4);                // borné à 1 / maxAdjustFactor
+    std::cout << "Fenetres synthetiques (x2, /2, =, borne haute, borne basse) : " << (bOk ? "OK" : "ERREUR")
+              << std::endl;
+
+    // Cible limite : des blocs lents ne la dépassent jamais
+    DifficultyRetargeter atLimit(params, params.limitBits);
+    for (uint32_t i = 0; i < params.interval; ++i) {
+        atLimit.RecordBlock(100 * target);
+    }
+    bool bLimitOk = atLimit.Bits() == params.limitBits;
+    std::cout << "Cible limite respectee : " << (bLimitOk ? "oui" : "non") << std::endl;
+
+    // Mineur simulé : durée d'un bloc = hashes attendus pour la cible / débit
+    const double hashRate = 1e6;
+    DifficultyRetargeter simulated(params, compact_from_difficulty(2));
+    for (uint32_t w = 0; w < 12; ++w) {
+        for (uint32_t i = 0; i < params.interval; ++i) {
+            simulated.RecordBlock(target_expected_hashes(simulated.Target()) / hashRate);
+        }
+    }
+    double converged = target_expected_hashes(simulated.Target()) / hashRate;
+    bool bConverged = converged > target * 0.9 && converged < target * 1.1;
+    std::cout << "Mineur simule (" << hashRate << " H/s) : " << converged << " s/bloc apres 12 fenetres" << std::endl;
+
+    return bOk && bLimitOk && bConverged;
+}
+
+/**
+ * @brief Mine avec une cible ajustée toutes les 'interval' blocs et affiche
+ * la convergence du temps par bloc vers 'targetSeconds'. Retourne le temps
+ * moyen par bloc des 'nTailWindows' dernières fenêtres.
+ */
+double run_retargeting(HashMethod method, double targetSeconds, uint32_t nWindows, uint32_t nTailWindows) {
+    RetargetParams params = RETARGET_DEFAULT_PARAMS;
+    params.targetBlockSeconds = targetSeconds;
+
+    Blockchain chain(method, BlockFormat::BINARY_HEADER);
+    chain.SetVerbose(false);
+    chain.EnableRetargeting(params, compact_from_difficulty(3));
+
+    std::cout << std::fixed << std::setprecision(4);
+    double tailSeconds = 0.0;
+    for (uint32_t w = 0; w < nWindows; ++w) {
+        const uint32_t nBits = chain.Retargeter().Bits();
+        const double expectedHashes = target_expected_hashes(chain.Retargeter().Target());
+        double windowSeconds = 0.0;
+        for (uint32_t i = 0; i < params.interval; ++i) {
+            windowSeconds += chain.AddBlockPoWTarget("Bloc a cible ajustable");
+        }
+        if (w + nTailWindows >= nWindows) {
+            tailSeconds += windowSeconds;
+        }
+        std::cout << "Fenetre " << std::setw(2) << w << " : bits=0x" << std::hex << nBits << std::dec
+                  << ", " << std::setw(12) << std::setprecision(0) << expectedHashes << " hashes attendus, "
+                  << std::setprecision(4) << windowSeconds / params.interval << " s/bloc" << std::endl;
+    }
+    std::cout << std::setprecision(6);
+    std::cout.unsetf(std::ios::fixed);
+    return tailSeconds / (nTailWindows * params.interval);
+}
+// --- FIN Cible 256 bits ---
 
 
 // --- FONCTION MAIN (Réponse à la Q4) ---
+/**
+ * @brief Vérifie que la cible compacte est engagée dans le hash et contrôlée
+ * par validate_chain_pow : un bloc miné avec 'bits' X puis déclaré plus
+ * difficile doit être rejeté, qu'on garde son hash ou qu'on le recalcule.
+ */
+bool verify_target_commitment() {
+    const uint32_t nBits = compact_from_difficulty(2);
+    const uint32_t nHarderBits = 0x03000001; // cible = 1 : aucun hash réel ne la respecte
+    ThreadPool pool(2);
+    ParallelMiner miner(pool);
+    bool bOk = true;
+
+    for (BlockFormat format : {BlockFormat::LEGACY_STRING, BlockFormat::BINARY_HEADER}) {
+        std::vector<Block> chain;
+        chain.emplace_back(0, "Genesis Block", HashMethod::SHA256, format);
+        chain.back().MineBlock(1, miner);
+        for (uint32_t i = 1; i <= 4; ++i) {
+            Block block(i, "Bloc a cible " + std::to_string(i), HashMethod::SHA256, format);
+            block.prevHash = chain.back().hash;
+            block.MineBlockTarget(nBits, miner);
+            chain.push_back(std::move(block));
+        }
+        const bool bValid = validate_chain_pow(chain, pool).valid;
+
+        // 1. Cible durcie, hash d'origine : le hash ne correspond plus (bits engagés)
+        Block& last = chain.back();
+        last._nBits = nHarderBits;
+        ValidationResult changed = validate_chain_pow(chain, pool);
+
+        // 2. Hash recalculé : correct, mais au-dessus de la nouvelle cible
+        last.hash = last.recalculatePoWHash();
+        ValidationResult rehashed = validate_chain_pow(chain, pool);
+
+        bool bFormatOk = bValid && !changed.valid && changed.reason == ValidationError::BAD_HASH &&
+                         changed.badIndex == 4 && !rehashed.valid &&
+                         rehashed.reason == ValidationError::BAD_TARGET && rehashed.badIndex == 4;
+        std::cout << (format == BlockFormat::LEGACY_STRING ? "Preimage texte" : "En-tete binaire")
+                  << " : chaine minee " << (bValid ? "valide" : "invalide") << ", bits durcis : "
+                  << (changed.valid ? "valide" : changed.Reason()) << ", rehache : "
+                  << (rehashed.valid ? "valide" : rehashed.Reason()) << (bFormatOk ? " (OK)" : " (ERREUR)")
+                  << std::endl;
+        bOk = bOk && bFormatOk;
+    }
+    return bOk;
+}
+
 int main() {
     // Paramètres du test
     const int num_blocks_to_test = 10; // 4.1: Minage de 10 blocs
     const uint32_t difficulty = 4;     // 4.2: Difficulté fixe
     
     std::cout << "--- DEBUT DU TEST DE PERFORMANCE (Q4) ---" << std::endl;
-    std::cout << "Parametres: " << num_blocks_to_test << " blocs, difficulte = " << difficulty << std::endl;
+    std::cout << "Parametres: " << num_blocks_to_test << " blocs, difficulte = " << difficulty
+              << ", " << std::thread::hardware_concurrency() << " threads de minage" << std::endl;
+
+    // Le minage multithread suppose un SHA256 réentrant : on le vérifie d'abord.
+    std::cout << "\n--- Verification : SHA256 depuis plusieurs threads ---" << std::endl;
+    if (verify_concurrent_sha256(8, 20000)) {
+        std::cout << "VERIFICATION REUSSIE : tous les hashes concurrents sont corrects." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : des hashes concurrents sont corrompus !" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n--- Verification : backends SHA256 contre le code scalaire ---" << std::endl;
+    if (verify_sha256_backends()) {
+        std::cout << "VERIFICATION REUSSIE : tous les backends donnent les memes octets que SCALAR." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : un backend SHA256 differe du code scalaire !" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n--- Verification : NonceHasher contre la preimage complete ---" << std::endl;
+    if (verify_nonce_hasher()) {
+        std::cout << "VERIFICATION REUSSIE : midstate et buffer reecrit donnent le hash de base + nonce." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : NonceHasher differe de la preimage complete !" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n--- Charge soutenue (en-tete binaire, difficulte " << difficulty << ", 2 s par methode) ---" << std::endl;
+    run_sustained_mining(difficulty, 2.0);
+    std::cout << std::setprecision(6);
+    std::cout.unsetf(std::ios::fixed);
+
+    std::cout << "\n--- Verification : cible compacte \"bits\" ---" << std::endl;
+    if (verify_compact_target()) {
+        std::cout << "VERIFICATION REUSSIE : encodage compact et equivalence avec la difficulte." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : cible compacte incorrecte !" << std::endl;
+        return 1;
+    }
+
+    const double targetBlockSeconds = 0.02;
+    std::cout << "\n--- Ajustement de difficulte (SHA256, " << targetBlockSeconds << " s/bloc vises, "
+              << RETARGET_DEFAULT_PARAMS.interval << " blocs par fenetre) ---" << std::endl;
+    double tailAverage = run_retargeting(HashMethod::SHA256, targetBlockSeconds, 10, 3);
+    // Mesure en temps réel : rapportée seulement (dépend de la charge de la machine)
+    std::cout << "Temps moyen des 3 dernieres fenetres : " << tailAverage << " s/bloc (vise : "
+              << targetBlockSeconds << ")" << std::endl;
+
+    std::cout << "\n--- Verification : regles d'ajustement (durees synthetiques) ---" << std::endl;
+    if (verify_retarget_rules()) {
+        std::cout << "VERIFICATION REUSSIE : cible ajustee, bornee et convergente." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : ajustement de difficulte incorrect !" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n--- Verification : cible engagee dans le hash des blocs ---" << std::endl;
+    if (verify_target_commitment()) {
+        std::cout << "VERIFICATION REUSSIE : une cible durcie apres minage est rejetee." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : la cible des blocs n'est pas verifiee !" << std::endl;
+        return 1;
+    }
 
     // --- Test 1: SHA256 ---
     std::cout << "\n--- Test 1: SHA256 ---" << std::endl;
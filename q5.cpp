@@ -3,63 +3,51 @@
 #include <vector>
 #include <iomanip> // Pour std::setprecision
 #include <stdexcept>
+#include <cstdlib> // Pour std::strtoull
 
 // Inclut notre fonction de hachage de la Q2
 #include "ac_hash.hpp"
+#include "avalanche.hpp" // Analyse d'avalanche parallèle (matrice SAC)
 
 /**
- * @brief Fonction utilitaire pour convertir un hash hexadécimal en un vecteur de bits (bools).
- * C'est l'inverse de bits_to_hex_string.
+ * @brief Vérifie que le chemin de l'analyse (bit inversé dans l'état replié,
+ * puis ac_evolve_batch) donne exactement ac_hash_bytes du message modifié.
  */
-std::vector<bool> hex_hash_to_bits(const std::string& hex_hash) {
-    if (hex_hash.length() != HASH_SIZE_BITS / 4) {
-        throw std::runtime_error("Taille du hash hexadécimal incorrecte.");
-    }
-
-    std::vector<bool> bits;
-    bits.reserve(HASH_SIZE_BITS);
-
-    for (char c : hex_hash) {
-        uint8_t val;
-        // Convertit le caractère hexadécimal en sa valeur numérique (0-15)
-        if (c >= '0' && c <= '9') {
-            val = c - '0';
-        } else if (c >= 'a' && c <= 'f') {
-            val = c - 'a' + 10;
-        } else if (c >= 'A' && c <= 'F') {
-            val = c - 'A' + 10;
-        } else {
-            throw std::runtime_error("Caractere hexadecimal invalide.");
-        }
-
-        // Extrait les 4 bits de cette valeur
-        for (int i = 3; i >= 0; --i) {
-            bits.push_back((val >> i) & 1);
+bool verify_avalanche_path(uint32_t rule, size_t steps) {
+    uint8_t states[2][HASH_SIZE_BYTES];
+    uint8_t digests[2][HASH_SIZE_BYTES];
+    for (uint64_t m = 0; m < 8; ++m) {
+        uint8_t message[HASH_SIZE_BYTES];
+        avalanche_message(5, m, message);
+        for (size_t bit = 0; bit < AVALANCHE_INPUT_BITS; bit += 37) {
+            string_to_bytes(message, sizeof(message), states[0], HASH_SIZE_BYTES);
+            states[0][bit / 8] ^= static_cast<uint8_t>(0x80 >> (bit % 8));
+            ac_evolve_batch(states, 1, rule, steps, digests);
+
+            uint8_t flipped[HASH_SIZE_BYTES];
+            std::memcpy(flipped, message, sizeof(flipped));
+            flipped[bit / 8] ^= static_cast<uint8_t>(0x80 >> (bit % 8));
+            uint8_t expected[HASH_SIZE_BYTES];
+            ac_hash_bytes(flipped, sizeof(flipped), rule, steps, expected);
+            if (std::memcmp(expected, digests[0], HASH_SIZE_BYTES) != 0) {
+                return false;
+            }
         }
     }
-    return bits;
+    return true;
 }
 
-/**
- * @brief Compare deux vecteurs de bits et retourne le nombre de bits différents.
- * C'est ce qu'on appelle la "distance de Hamming".
- */
-int calculate_bit_differences(const std::vector<bool>& h1_bits, const std::vector<bool>& h2_bits) {
-    if (h1_bits.size() != h2_bits.size()) {
-        throw std::runtime_error("Les hashes n'ont pas la meme taille de bits.");
-    }
-
-    int diff_count = 0;
-    for (size_t i = 0; i < h1_bits.size(); ++i) {
-        if (h1_bits[i] != h2_bits[i]) {
-            diff_count++;
-        }
-    }
-    return diff_count;
+void print_avalanche_report(const AvalancheReport& r) {
+    std::cout << "Regle " << std::setw(3) << r.config.rule << ", " << std::setw(3) << r.config.steps << " etapes : "
+              << std::fixed << std::setprecision(2) << "distance moy. " << std::setw(6) << r.meanDistance
+              << " [" << std::setw(3) << r.minDistance << ", " << std::setw(3) << r.maxDistance << "], "
+              << std::setprecision(4) << "biais SAC max " << r.maxSacBias << " (sigma " << r.SacSigma() << "), "
+              << r.deadPairs << " cases mortes, " << std::setprecision(2) << r.seconds << " s -> "
+              << (r.MeetsSac() ? "SAC OK" : "SAC NON RESPECTE") << std::endl;
 }
 
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "--- TEST DE L'EFFET AVALANCHE (Q5) ---" << std::endl;
 
     // Paramètres du test
@@ -79,20 +67,16 @@ int main() {
     std::cout << "Message 2: \"" << message2 << "\"" << std::endl;
     std::cout << "----------------------------------------" << std::endl;
 
-    // 2. Hacher les deux messages
-    std::string hash1_hex = ac_hash(message1, rule, steps);
-    std::string hash2_hex = ac_hash(message2, rule, steps);
+    // 2. Hacher les deux messages (hashes bruts, l'hexadécimal ne sert qu'à l'affichage)
+    std::array<uint8_t, HASH_SIZE_BYTES> hash1 = ac_hash_raw(message1, rule, steps);
+    std::array<uint8_t, HASH_SIZE_BYTES> hash2 = ac_hash_raw(message2, rule, steps);
 
-    std::cout << "Hash 1 (hex): " << hash1_hex << std::endl;
-    std::cout << "Hash 2 (hex): " << hash2_hex << std::endl;
+    std::cout << "Hash 1 (hex): " << bytes_to_hex_string(hash1.data(), hash1.size()) << std::endl;
+    std::cout << "Hash 2 (hex): " << bytes_to_hex_string(hash2.data(), hash2.size()) << std::endl;
     std::cout << "----------------------------------------" << std::endl;
 
-    // 3. Convertir les hashes hexadécimaux en vecteurs de bits
-    std::vector<bool> hash1_bits = hex_hash_to_bits(hash1_hex);
-    std::vector<bool> hash2_bits = hex_hash_to_bits(hash2_hex);
-
-    // 4. Calculer les différences
-    int differences = calculate_bit_differences(hash1_bits, hash2_bits);
+    // 3-4. Calculer les différences (distance de Hamming par popcount)
+    int differences = static_cast<int>(avalanche_hamming_distance(hash1.data(), hash2.data(), HASH_SIZE_BYTES));
 
     // 5.1. Calculer le pourcentage
     double percentage = (static_cast<double>(differences) / HASH_SIZE_BITS) * 100.0;
@@ -113,5 +97,39 @@ int main() {
         std::cout << "\nConclusion : FAIBLE effet avalanche. (Resultat non ideal)" << std::endl;
     }
 
+    // --- Analyse sur M messages : chaque bit d'entrée inversé, matrice SAC ---
+    // Usage : q5 [nombre de messages] (256 inversions par message)
+    const uint64_t num_messages = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 2048;
+    ThreadPool pool;
+
+    std::cout << "\n--- Verification : inversion dans l'etat replie == ac_hash du message modifie ---" << std::endl;
+    if (verify_avalanche_path(rule, steps) && verify_avalanche_path(45, 40)) {
+        std::cout << "VERIFICATION REUSSIE : l'analyse mesure bien ac_hash." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : l'analyse ne correspond pas a ac_hash !" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n--- Analyse d'avalanche : " << num_messages << " messages x " << AVALANCHE_INPUT_BITS
+              << " bits inverses, " << pool.Size() << " threads ---" << std::endl;
+    AvalancheAnalyzer analyzer(pool);
+    size_t min_passing_steps = 0; // plus petit nombre d'étapes respectant le SAC
+    for (size_t s : {16u, 32u, 64u, 96u, 112u, 128u}) {
+        AvalancheReport report = analyzer.Run(AvalancheConfig{rule, s, num_messages, 1});
+        print_avalanche_report(report);
+        if (report.MeetsSac() && min_passing_steps == 0) {
+            min_passing_steps = s;
+        }
+    }
+    if (min_passing_steps != 0) {
+        std::cout << "Regle " << rule << " : SAC respecte des " << min_passing_steps << " etapes." << std::endl;
+    } else {
+        std::cout << "Regle " << rule << " : aucun nombre d'etapes teste ne respecte le SAC "
+                  << "(baisser 'steps' n'est pas justifie)." << std::endl;
+    }
+    for (uint32_t r : {45u, 90u, 110u}) {
+        print_avalanche_report(analyzer.Run(AvalancheConfig{r, steps, num_messages, 1}));
+    }
+
     return 0;
-}
\ No newline at end of file
+}
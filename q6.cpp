@@ -3,35 +3,86 @@
 #include <vector>
 #include <iomanip> // Pour std::setprecision
 #include <stdexcept>
-#include <numeric> // Pour std::accumulate
+#include <cstdlib> // Pour std::strtoull
 
 // Inclut notre fonction de hachage de la Q2
 #include "ac_hash.hpp"
+#include "sha256.hpp"       // Flux témoin
+#include "randomness_tests.hpp" // Batterie de tests statistiques (NIST SP 800-22)
 
 /**
- * @brief Fonction utilitaire (de la Q5) pour convertir un hash hexadécimal en bits.
+ * @brief Convertit une chaîne de '0'/'1' en octets (poids fort d'abord).
  */
-std::vector<bool> hex_hash_to_bits(const std::string& hex_hash) {
-    if (hex_hash.length() != HASH_SIZE_BITS / 4) {
-        throw std::runtime_error("Taille du hash hexadécimal incorrecte.");
+std::vector<uint8_t> bits_from_string(const std::string& bits) {
+    std::vector<uint8_t> bytes((bits.size() + 7) / 8, 0);
+    for (size_t i = 0; i < bits.size(); ++i) {
+        if (bits[i] == '1') {
+            bytes[i / 8] |= static_cast<uint8_t>(0x80 >> (i % 8));
+        }
     }
-    std::vector<bool> bits;
-    bits.reserve(HASH_SIZE_BITS);
-    for (char c : hex_hash) {
-        uint8_t val;
-        if (c >= '0' && c <= '9') { val = c - '0'; }
-        else if (c >= 'a' && c <= 'f') { val = c - 'a' + 10; }
-        else if (c >= 'A' && c <= 'F') { val = c - 'A' + 10; }
-        else { throw std::runtime_error("Caractere hexadecimal invalide."); }
-        for (int i = 3; i >= 0; --i) {
-            bits.push_back((val >> i) & 1);
+    return bytes;
+}
+
+/**
+ * @brief Exemples chiffrés de NIST SP 800-22 (section 2) : chaque test doit
+ * retrouver la p-valeur publiée.
+ */
+bool verify_randomness_tests() {
+    const std::string eps100 = "11001001000011111101101010100010001000010110100011"
+                               "00001000110100110001001100011001100010100010111000";
+    const std::string eps128 = "11001100000101010110110001001100111000000000001001"
+                               "00110101010001000100111101011010000000110101111100"
+                               "1100111001101101100010110010";
+    std::vector<uint8_t> b100 = bits_from_string(eps100);
+    std::vector<uint8_t> b128 = bits_from_string(eps128);
+    std::vector<uint8_t> b_serial = bits_from_string("0011011101");
+    std::vector<uint8_t> b_apen = bits_from_string("0100110101");
+    BitSequence s100{b100.data(), eps100.size()};
+    BitSequence s128{b128.data(), eps128.size()};
+
+    double serial1 = 0.0, serial2 = 0.0;
+    randomness_serial(BitSequence{b_serial.data(), 10}, 3, serial1, serial2);
+
+    struct Case {
+        const char* name;
+        double actual;
+        double expected;
+    };
+    const Case cases[] = {
+        {"frequence", randomness_monobit(s100), 0.109599},
+        {"frequence_blocs", randomness_block_frequency(s100, 10), 0.706438},
+        {"series", randomness_runs(s100), 0.500798},
+        {"plus_longue_serie", randomness_longest_run(s128), 0.180609},
+        {"seriel_1", serial1, 0.808792},
+        {"seriel_2", serial2, 0.670320},
+        {"entropie_approx", randomness_approximate_entropy(BitSequence{b_apen.data(), 10}, 3), 0.261961},
+    };
+    bool bOk = true;
+    for (const Case& c : cases) {
+        if (std::fabs(c.actual - c.expected) > 1e-5) {
+            std::cout << c.name << " : p = " << c.actual << ", attendu " << c.expected << std::endl;
+            bOk = false;
         }
     }
-    return bits;
+    return bOk;
+}
+
+void print_randomness_report(const std::string& name, const RandomnessReport& r) {
+    std::cout << name << " : " << r.bytesTested / (1 << 20)
+              << " Mo en " << std::fixed << std::setprecision(2) << r.seconds << " s ("
+              << r.bytesTested / r.seconds / (1 << 20) << " Mo/s)" << std::endl;
+    for (int test = 0; test < RT_COUNT; ++test) {
+        const RandomnessTestSummary& t = r.tests[test];
+        std::cout << "  " << std::left << std::setw(18) << randomness_test_name(test) << std::right
+                  << std::setw(4) << t.passed << "/" << r.config.segments << " reussis, uniformite p="
+                  << std::setprecision(4) << t.uniformityP << " -> "
+                  << (t.Passes(r.config.segments) ? "OK" : "ECHEC") << std::endl;
+    }
+    std::cout << "  Conclusion : " << (r.AllPass() ? "aucun defaut detecte." : "sortie NON aleatoire.") << std::endl;
 }
 
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "--- TEST DE DISTRIBUTION DES BITS (Q6) ---" << std::endl;
 
     // Paramètres du test
@@ -51,23 +102,15 @@ int main() {
         // 1. Génère un input unique pour chaque hash
         std::string input = "un_message_different_pour_le_test_" + std::to_string(i);
 
-        // 2. Calcule le hash
-        std::string hash_hex = ac_hash(input, rule, steps);
+        // 2. Calcule le hash (brut : pas d'aller-retour par l'hexadécimal)
+        std::array<uint8_t, HASH_SIZE_BYTES> hash = ac_hash_raw(input, rule, steps);
 
-        // 3. Convertit le hash en bits
-        std::vector<bool> hash_bits = hex_hash_to_bits(hash_hex);
-
-        // 4. Compte les bits à '1' dans ce hash
-        int ones_in_this_hash = 0;
-        for (bool bit : hash_bits) {
-            if (bit) {
-                ones_in_this_hash++;
-            }
-        }
+        // 3-4. Compte les bits à '1' dans ce hash
+        BitSequence hash_bits{hash.data(), HASH_SIZE_BITS};
         
         // 5. Ajoute aux totaux
-        total_ones_count += ones_in_this_hash;
-        total_bits_sampled += hash_bits.size(); // (ajoute 256)
+        total_ones_count += static_cast<long long>(hash_bits.Ones(0, HASH_SIZE_BITS));
+        total_bits_sampled += HASH_SIZE_BITS; // (ajoute 256)
     }
 
     // --- 6.1. Calcule le pourcentage ---
@@ -92,5 +135,53 @@ int main() {
         std::cout << "\nConclusion : La distribution N'EST PAS equilibree (loin de 50%)." << std::endl;
     }
 
+    // --- Batterie de tests sur un flux de hashes bruts, par (regle, etapes) ---
+    // Usage : q6 [nombre de segments de 1 Mbit]
+    const size_t num_segments = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 32;
+
+    std::cout << "\n--- Verification : exemples de NIST SP 800-22 ---" << std::endl;
+    if (verify_randomness_tests()) {
+        std::cout << "VERIFICATION REUSSIE : chaque test retrouve la p-valeur publiee." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : un test statistique est incorrect !" << std::endl;
+        return 1;
+    }
+
+    ThreadPool pool;
+    RandomnessSuite suite(pool);
+    std::cout << "\n--- Batterie statistique : " << num_segments << " segments de "
+              << RANDOMNESS_DEFAULT_SEGMENT_BITS << " bits, " << pool.Size() << " threads ---" << std::endl;
+
+    // Témoin : SHA256 des mêmes compteurs. La batterie doit l'accepter, sinon
+    // les échecs d'ac_hash ne prouveraient rien.
+    RandomnessConfig control{0, 0, num_segments, RANDOMNESS_DEFAULT_SEGMENT_BITS};
+    RandomnessReport control_report = suite.RunGenerator(control,
+        [&](size_t segment, std::vector<uint8_t>&, std::vector<uint8_t>& output) {
+            const size_t nDigests = output.size() / 32;
+            for (size_t k = 0; k < nDigests; ++k) {
+                uint8_t counter[8];
+                uint64_t value = static_cast<uint64_t>(segment) * nDigests + k;
+                for (int i = 0; i < 8; ++i) {
+                    counter[i] = static_cast<uint8_t>(value >> (8 * i));
+                }
+                std::array<uint8_t, 32> digest = sha256_raw(counter, sizeof(counter));
+                std::memcpy(&output[32 * k], digest.data(), digest.size());
+            }
+        });
+    print_randomness_report("Temoin SHA256", control_report);
+    if (control_report.AllPass()) {
+        std::cout << "VERIFICATION REUSSIE : la batterie accepte le flux temoin." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : la batterie rejette le flux temoin !" << std::endl;
+        return 1;
+    }
+
+    const std::pair<uint32_t, size_t> configs[] = {{30, 128}, {30, 64}, {45, 128}, {90, 128}, {110, 128}};
+    for (const auto& c : configs) {
+        print_randomness_report("Regle " + std::to_string(c.first) + ", " + std::to_string(c.second) + " etapes",
+                                suite.Run(RandomnessConfig{c.first, c.second, num_segments,
+                                                           RANDOMNESS_DEFAULT_SEGMENT_BITS}));
+    }
+
     return 0;
-}
\ No newline at end of file
+}
@@ -3,42 +3,301 @@
 #include <vector>
 #include <iomanip> // Pour std::setprecision
 #include <stdexcept>
-#include <chrono> // Pour le chronomètre
+#include <algorithm> // Pour std::min
 
 // Inclut notre fonction de hachage de la Q2
 #include "ac_hash.hpp"
+#include "ac_hash_batch.hpp"
+#include "ac_sponge.hpp" // AcHasher : absorption par blocs (entrées longues)
+#include "ac_hash_lut.hpp" // Moteur à tables (4 générations par consultation)
+#include "bench.hpp" // Chauffe + échantillons répétés (médiane, p99)
+
+// Messages "message_test_<i>", préparés hors du chronomètre
+std::vector<std::string> make_test_inputs(int num_hashes) {
+    std::vector<std::string> inputs(num_hashes);
+    for (int i = 0; i < num_hashes; ++i) {
+        inputs[i] = "message_test_" + std::to_string(i);
+    }
+    return inputs;
+}
+
+// Affiche une mesure et retourne le temps médian de génération des hashes
+double report_measure(const BenchResult& result) {
+    double time_taken = result.medianNsPerCall * 1e-9;
+    std::cout << " Termine en " << std::fixed << std::setprecision(4) << time_taken
+              << " secondes (mediane de " << result.samples << " mesures, p99 "
+              << result.p99NsPerCall * 1e-9 << " s)." << std::endl;
+    return time_taken;
+}
 
 /**
  * @brief Fonction de test qui chronomètre la génération de 'num_hashes' hashes
  * en utilisant une règle spécifique.
- * @return Le temps total d'exécution en secondes.
+ * @return Le temps médian d'exécution en secondes.
  */
-double run_performance_test(uint32_t rule_number, int num_hashes_to_generate) {
+double run_performance_test(BenchRunner& runner, uint32_t rule_number, int num_hashes_to_generate) {
     
     std::cout << "Test de la Regle " << rule_number << " (generation de " 
               << num_hashes_to_generate << " hashes)..." << std::flush;
 
     // Paramètres constants
     const size_t steps = 128;
+    const std::vector<std::string> inputs = make_test_inputs(num_hashes_to_generate);
+
+    const BenchResult& result = runner.Run("q7", "ac_hash", "regle=" + std::to_string(rule_number), "hash", [&] {
+        for (const std::string& input : inputs) {
+            std::string hash = ac_hash(input, rule_number, steps);
+            bench_do_not_optimize(hash.data()[0]); // Empêche l'optimiseur de supprimer le calcul
+        }
+        return inputs.size();
+    });
+    return report_measure(result);
+}
+
+
+/**
+ * @brief Meme mesure que run_performance_test(), mais avec ac_hash_batch().
+ * @return Le temps médian d'exécution en secondes.
+ */
+double run_batch_performance_test(BenchRunner& runner, uint32_t rule_number, int num_hashes_to_generate) {
+
+    std::cout << "Test de la Regle " << rule_number << " en lot ("
+              << ac_batch_backend_name(ac_batch_best_backend()) << ")..." << std::flush;
+
+    const size_t steps = 128;
+
+    const std::vector<std::string> inputs = make_test_inputs(num_hashes_to_generate);
+    std::vector<uint8_t> digests(num_hashes_to_generate * HASH_SIZE_BYTES);
+    uint8_t (*out)[HASH_SIZE_BYTES] = reinterpret_cast<uint8_t (*)[HASH_SIZE_BYTES]>(digests.data());
+
+    const BenchResult& result = runner.Run("q7", "ac_hash_batch", "regle=" + std::to_string(rule_number), "hash", [&] {
+        ac_hash_batch(inputs.data(), inputs.size(), rule_number, steps, out);
+        bench_do_not_optimize(digests.data()[0]);
+        return inputs.size();
+    });
+    return report_measure(result);
+}
 
-    auto t_start = std::chrono::high_resolution_clock::now();
+/**
+ * @brief Vérifie que chaque voie de chaque backend SIMD disponible donne
+ * exactement le hash de la version scalaire ac_hash().
+ */
+bool verify_batch_lanes() {
+    const AcBatchBackend backends[] = {
+        AcBatchBackend::SCALAR, AcBatchBackend::SSE2, AcBatchBackend::AVX2, AcBatchBackend::AVX512
+    };
+    const uint32_t rules[] = {30, 90, 110, 0, 45, 150, 255};
 
-    // Boucle de génération de hashes
-    for (int i = 0; i < num_hashes_to_generate; ++i) {
-        std::string input = "message_test_" + std::to_string(i);
-        // On génère le hash, mais on ne le stocke pas pour ne pas
-        // mesurer le coût de l'allocation mémoire.
-        volatile std::string hash = ac_hash(input, rule_number, steps);
-        (void)hash; // Empêche l'optimiseur de supprimer la ligne
+    // 37 messages : plusieurs lots complets + un lot partiel pour chaque largeur.
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 37; ++i) {
+        inputs.push_back("verification_" + std::to_string(i) + std::string(i, 'x'));
     }
+    uint8_t out[37][HASH_SIZE_BYTES];
 
-    auto t_end = std::chrono::high_resolution_clock::now();
-    double time_taken = std::chrono::duration<double>(t_end - t_start).count();
+    bool ok = true;
+    for (AcBatchBackend backend : backends) {
+        if (!ac_batch_backend_supported(backend)) {
+            continue;
+        }
+        for (uint32_t rule : rules) {
+            for (size_t steps : {size_t(1), size_t(128)}) {
+                ac_hash_batch(inputs.data(), inputs.size(), rule, steps, out, backend);
+                for (size_t i = 0; i < inputs.size(); ++i) {
+                    if (bytes_to_hex_string(out[i], HASH_SIZE_BYTES) != ac_hash(inputs[i], rule, steps)) {
+                        std::cout << "Voie " << i % ac_batch_lanes(backend) << " incorrecte ("
+                                  << ac_batch_backend_name(backend) << ", regle " << rule << ")" << std::endl;
+                        ok = false;
+                    }
+                }
+            }
+        }
+    }
+    return ok;
+}
 
-    std::cout << " Termine en " << std::fixed << std::setprecision(4) 
-              << time_taken << " secondes." << std::endl;
-              
-    return time_taken;
+
+/**
+ * @brief AcHasher : le hash ne dépend pas du découpage des update(), le
+ * noyau générique donne le même résultat que le noyau dédié, un objet
+ * réutilisé après finalize() repart de zéro, et deux entrées qui s'annulent
+ * dans le repliement de ac_hash restent distinctes.
+ */
+bool verify_sponge() {
+    std::vector<uint8_t> data(5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 131 + 17);
+    }
+    for (size_t length : {size_t(0), size_t(15), size_t(16), size_t(17), size_t(1000), data.size()}) {
+        std::array<uint8_t, HASH_SIZE_BYTES> expected = ac_sponge_hash(data.data(), length, 30);
+        AcHasher<> generic(30);
+        if (generic.update(data.data(), length).finalize() != expected) {
+            return false;
+        }
+        for (size_t chunk : {size_t(1), size_t(7), size_t(16), size_t(333)}) {
+            AcHasher<30> hasher(30);
+            for (size_t offset = 0; offset < length; offset += chunk) {
+                hasher.update(data.data() + offset, std::min(chunk, length - offset));
+            }
+            if (hasher.finalize() != expected) {
+                return false;
+            }
+        }
+        // Réutilisation sans reset() explicite : même hash
+        if (generic.update(data.data(), length).finalize() != expected) {
+            return false;
+        }
+    }
+
+    // Même XOR aux octets 0 et 32 : le repliement de ac_hash les annule
+    std::vector<uint8_t> other(data.begin(), data.begin() + 64);
+    other[0] ^= 0x5a;
+    other[32] ^= 0x5a;
+    bool bFoldCollides = ac_hash_raw(data.data(), 64, 30, 128) == ac_hash_raw(other.data(), 64, 30, 128);
+    bool bSpongeDiffers = ac_sponge_hash(data.data(), 64, 30) != ac_sponge_hash(other.data(), 64, 30);
+    return bFoldCollides && bSpongeDiffers;
+}
+
+/**
+ * @brief Débit (Mo/s) du repliement + 128 générations contre l'éponge, par taille d'entrée.
+ */
+void run_sponge_throughput(BenchRunner& runner) {
+    std::vector<uint8_t> data(size_t(1) << 20);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    std::cout << "+----------+---------------------+---------------------+" << std::endl;
+    std::cout << "| Entree   | Repliement (Mo/s)   | Eponge (Mo/s)       |" << std::endl;
+    std::cout << "+----------+---------------------+---------------------+" << std::endl;
+    for (size_t size : {size_t(64), size_t(1024), size_t(65536), data.size()}) {
+        const std::string params = "octets=" + std::to_string(size);
+        double fold = runner.Run("q7", "ac_hash_repliement", params, "octet", [&] {
+            uint8_t out[HASH_SIZE_BYTES];
+            ac_hash_bytes(data.data(), size, 30, 128, out);
+            bench_do_not_optimize(out);
+            return size;
+        }).unitsPerSecond;
+        double sponge = runner.Run("q7", "ac_sponge", params, "octet", [&] {
+            std::array<uint8_t, HASH_SIZE_BYTES> out = ac_sponge_hash(data.data(), size, 30);
+            bench_do_not_optimize(out);
+            return size;
+        }).unitsPerSecond;
+        std::cout << "| " << std::left << std::setw(8) << size << std::right << " | "
+                  << std::setw(19) << std::setprecision(1) << fold / 1e6 << " | "
+                  << std::setw(19) << sponge / 1e6 << " |" << std::endl;
+    }
+    std::cout << "+----------+---------------------+---------------------+" << std::endl;
+}
+
+
+/**
+ * @brief Chaque moteur (scalaire, bitslice, dédié, table) donne ac_hash()
+ * pour les 256 règles, y compris pour des 'steps' non multiples de 4.
+ */
+bool verify_engines() {
+    const AcEngine engines[] = {AcEngine::SCALAR, AcEngine::BITSLICE_ANF, AcEngine::BITSLICE_RULE, AcEngine::LUT};
+    const std::string input = "verification_moteurs_" + std::string(40, 'x');
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(input.data());
+    for (uint32_t rule = 0; rule < 256; ++rule) {
+        for (size_t steps : {size_t(0), size_t(1), size_t(3), size_t(4), size_t(7), size_t(128)}) {
+            uint8_t expected[HASH_SIZE_BYTES];
+            ac_hash_bytes(data, input.size(), rule, steps, expected);
+            for (AcEngine engine : engines) {
+                if (!ac_engine_supported(engine, rule)) {
+                    continue;
+                }
+                uint8_t out[HASH_SIZE_BYTES];
+                ac_hash_bytes_engine(engine, data, input.size(), rule, steps, out);
+                if (std::memcmp(out, expected, HASH_SIZE_BYTES) != 0) {
+                    std::cout << "Moteur " << ac_engine_name(engine) << " incorrect (regle " << rule
+                              << ", " << steps << " etapes)" << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Mesure les moteurs pour les 256 règles et affiche le moteur retenu.
+ */
+void run_engine_comparison() {
+    const AcEngine engines[] = {AcEngine::SCALAR, AcEngine::BITSLICE_ANF, AcEngine::BITSLICE_RULE, AcEngine::LUT};
+    std::cout << "+----------+------------+------------+----------------+------------+----------------+" << std::endl;
+    std::cout << "| Regle    | scalaire   | bitslice   | bitslice_dedie | table      | retenu         |" << std::endl;
+    std::cout << "+----------+------------+------------+----------------+------------+----------------+" << std::endl;
+    for (uint32_t rule : {30u, 90u, 110u, 45u, 150u}) {
+        std::cout << "| Rule " << std::left << std::setw(4) << rule << std::right;
+        for (AcEngine engine : engines) {
+            int width = (engine == AcEngine::BITSLICE_RULE) ? 14 : 10;
+            if (ac_engine_supported(engine, rule)) {
+                std::cout << "| " << std::setw(width) << std::setprecision(0) << ac_engine_measure(engine, rule) << " ";
+            } else {
+                std::cout << "| " << std::setw(width) << "-" << " ";
+            }
+        }
+        std::cout << "| " << std::left << std::setw(14) << ac_engine_name(ac_engine_select(static_cast<uint8_t>(rule)))
+                  << std::right << " |" << std::endl;
+    }
+    std::cout << "+----------+------------+------------+----------------+------------+----------------+" << std::endl;
+    std::cout << "(ns par hash de " << AC_ENGINE_CALIBRATION_STEPS << " generations)" << std::endl;
+
+    int wins[4] = {0, 0, 0, 0};
+    for (uint32_t rule = 0; rule < 256; ++rule) {
+        ++wins[static_cast<int>(ac_engine_select(static_cast<uint8_t>(rule)))];
+    }
+    std::cout << "Moteur retenu sur les 256 regles :";
+    for (AcEngine engine : engines) {
+        std::cout << " " << ac_engine_name(engine) << "=" << wins[static_cast<int>(engine)];
+    }
+    std::cout << std::endl;
+}
+
+
+/**
+ * @brief La largeur 256 redonne ac_hash() et un hash tronqué est le préfixe
+ * du hash complet de la même largeur.
+ */
+bool verify_widths() {
+    const std::string input = "verification_largeurs";
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(input.data());
+    for (uint32_t rule : {30u, 90u, 110u, 45u}) {
+        uint8_t expected[HASH_SIZE_BYTES];
+        ac_hash_bytes(data, input.size(), rule, 128, expected);
+        std::array<uint8_t, 32> digest256 = ac_hash_raw_width<256>(data, input.size(), rule, 128);
+        if (std::memcmp(digest256.data(), expected, HASH_SIZE_BYTES) != 0) {
+            return false;
+        }
+        std::array<uint8_t, 128> digest1024 = ac_hash_raw_width<1024>(data, input.size(), rule, 512);
+        std::array<uint8_t, 32> digest1024_256 = ac_hash_raw_width<1024, 256>(data, input.size(), rule, 512);
+        if (std::memcmp(digest1024.data(), digest1024_256.data(), digest1024_256.size()) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Temps médian (ns) d'un hash de largeur WidthBits après 'steps' générations
+template <size_t WidthBits>
+double measure_width(BenchRunner& runner, size_t steps) {
+    const std::string input = "message_test_largeur";
+    uint8_t out[WidthBits / 8];
+    return runner.Run("q7", "ac_hash_largeur", "largeur=" + std::to_string(WidthBits) + ",etapes=" +
+                      std::to_string(steps), "hash", [&] {
+        ac_hash_bytes_width<WidthBits>(reinterpret_cast<const uint8_t*>(input.data()), input.size(), 30, steps, out);
+        bench_do_not_optimize(out);
+        return 1;
+    }).medianNsPerCall;
+}
+
+template <size_t WidthBits>
+void report_width(BenchRunner& runner) {
+    double fixed = measure_width<WidthBits>(runner, 128);
+    double diffusion = measure_width<WidthBits>(runner, WidthBits / 2);
+    std::cout << "| " << std::setw(8) << WidthBits << " | " << std::setw(16) << std::setprecision(0) << fixed
+              << " | " << std::setw(9) << WidthBits / 2 << " | " << std::setw(16) << diffusion
+              << " | " << std::setw(12) << std::setprecision(2) << diffusion / (WidthBits / 8) << " |" << std::endl;
 }
 
 
@@ -47,22 +306,76 @@ int main() {
 
     // Un grand nombre pour avoir une mesure de temps significative
     const int num_hashes = 20000; 
+    BenchRunner runner(BENCH_QUICK_CONFIG); // chaque appel génère déjà 20000 hashes
 
     // --- 7.1. Exécute ac_hash avec les 3 règles ---
     // (Les citations [cite: 33] ont été supprimées d'ici)
-    double time_rule_30 = run_performance_test(30, num_hashes);
-    double time_rule_90 = run_performance_test(90, num_hashes);
-    double time_rule_110 = run_performance_test(110, num_hashes);
+    double time_rule_30 = run_performance_test(runner, 30, num_hashes);
+    double time_rule_90 = run_performance_test(runner, 90, num_hashes);
+    double time_rule_110 = run_performance_test(runner, 110, num_hashes);
+
+    double batch_rule_30 = run_batch_performance_test(runner, 30, num_hashes);
+    double batch_rule_90 = run_batch_performance_test(runner, 90, num_hashes);
+    double batch_rule_110 = run_batch_performance_test(runner, 110, num_hashes);
 
     // --- 7.2. Compare les temps d'exécution ---
     std::cout << "\n--- COMPARAISON (Q7.2) ---" << std::endl;
-    std::cout << "+----------+---------------------+" << std::endl;
-    std::cout << "| Regle    | Temps d'execution   |" << std::endl;
-    std::cout << "+----------+---------------------+" << std::endl;
-    std::cout << "| Rule 30  | " << std::setw(19) << time_rule_30 << " s |" << std::endl;
-    std::cout << "| Rule 90  | " << std::setw(19) << time_rule_90 << " s |" << std::endl;
-    std::cout << "| Rule 110 | " << std::setw(19) << time_rule_110 << " s |" << std::endl;
-    std::cout << "+----------+---------------------+" << std::endl;
+    std::cout << "+----------+---------------------+---------------------+" << std::endl;
+    std::cout << "| Regle    | Temps d'execution   | Temps en lot (SIMD) |" << std::endl;
+    std::cout << "+----------+---------------------+---------------------+" << std::endl;
+    std::cout << "| Rule 30  | " << std::setw(19) << time_rule_30 << " s | " << std::setw(17) << batch_rule_30 << " s |" << std::endl;
+    std::cout << "| Rule 90  | " << std::setw(19) << time_rule_90 << " s | " << std::setw(17) << batch_rule_90 << " s |" << std::endl;
+    std::cout << "| Rule 110 | " << std::setw(19) << time_rule_110 << " s | " << std::setw(17) << batch_rule_110 << " s |" << std::endl;
+    std::cout << "+----------+---------------------+---------------------+" << std::endl;
+
+    std::cout << "\nVerification des voies SIMD contre ac_hash()..." << std::endl;
+    if (verify_batch_lanes()) {
+        std::cout << "VERIFICATION REUSSIE : chaque voie donne le hash scalaire." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : au moins une voie differe !" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\nVerification de AcHasher (eponge)..." << std::endl;
+    if (verify_sponge()) {
+        std::cout << "VERIFICATION REUSSIE : hash independant du decoupage, pas d'annulation a 32 octets." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : AcHasher incorrect !" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\nVerification des moteurs (256 regles)..." << std::endl;
+    if (verify_engines()) {
+        std::cout << "VERIFICATION REUSSIE : tous les moteurs donnent ac_hash()." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : un moteur differe !" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n--- Moteurs d'evolution : selection automatique par regle ---" << std::endl;
+    run_engine_comparison();
+
+    std::cout << "\nVerification des largeurs d'automate..." << std::endl;
+    if (verify_widths()) {
+        std::cout << "VERIFICATION REUSSIE : largeur 256 == ac_hash(), hash tronque == prefixe." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : largeur d'automate incorrecte !" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n--- Cout par largeur d'automate (regle 30) ---" << std::endl;
+    std::cout << "+----------+------------------+-----------+------------------+--------------+" << std::endl;
+    std::cout << "| Largeur  | ns (128 etapes)  | etapes    | ns (largeur / 2) | ns / octet   |" << std::endl;
+    std::cout << "+----------+------------------+-----------+------------------+--------------+" << std::endl;
+    report_width<128>(runner);
+    report_width<256>(runner);
+    report_width<512>(runner);
+    report_width<1024>(runner);
+    std::cout << "+----------+------------------+-----------+------------------+--------------+" << std::endl;
+
+    std::cout << "\n--- Debit : repliement + 128 generations contre eponge ("
+              << AC_SPONGE_RATE_BYTES << " octets / " << AC_SPONGE_DEFAULT_ROUNDS << " generations) ---" << std::endl;
+    run_sponge_throughput(runner);
 
     return 0;
 }
\ No newline at end of file
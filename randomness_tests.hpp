@@ -0,0 +1,448 @@
+#ifndef RANDOMNESS_TESTS_HPP
+#define RANDOMNESS_TESTS_HPP
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "ac_hash.hpp"
+#include "ac_hash_batch.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * Batterie de tests statistiques (inspirée de NIST SP 800-22) sur la sortie
+ * brute de ac_hash (généralise q6.cpp).
+ *
+ * Le flux testé est la concaténation des hashes de compteurs 64 bits
+ * (ac_hash_bytes du compteur little-endian), produits par ac_evolve_batch
+ * directement depuis l'état replié : pas d'hexadécimal, pas de
+ * std::vector<bool>. Les bits sont lus octet par octet, poids fort d'abord.
+ *
+ * Le flux est découpé en segments (1 Mbit par défaut) testés en parallèle ;
+ * chaque test donne une p-valeur par segment. Comme dans NIST, on rapporte
+ * pour chaque test la proportion de segments réussis (p >= 0.01) et
+ * l'uniformité des p-valeurs (chi-deux sur 10 classes). Chaque segment ne
+ * dépend que de son numéro : le rapport ne dépend pas du nombre de threads.
+ */
+
+// Seuil de réussite d'un segment et d'uniformité des p-valeurs (NIST)
+const double RANDOMNESS_ALPHA = 0.01;
+const double RANDOMNESS_UNIFORMITY_ALPHA = 0.0001;
+const size_t RANDOMNESS_DEFAULT_SEGMENT_BITS = size_t(1) << 20;
+const size_t RANDOMNESS_SERIAL_M = 16;
+const size_t RANDOMNESS_APEN_M = 10;
+
+/**
+ * @brief Fonction gamma incomplète régularisée inférieure P(a, x) (série).
+ */
+inline double randomness_igam(double a, double x) {
+    if (x <= 0.0 || a <= 0.0) {
+        return 0.0;
+    }
+    double ax = a * std::log(x) - x - std::lgamma(a);
+    if (ax < -709.78) {
+        return 0.0;
+    }
+    double r = a, c = 1.0, sum = 1.0;
+    do {
+        r += 1.0;
+        c *= x / r;
+        sum += c;
+    } while (c / sum > 1.11e-16);
+    return sum * std::exp(ax) / a;
+}
+
+/**
+ * @brief Fonction gamma incomplète régularisée supérieure Q(a, x) = 1 - P(a, x)
+ * (fraction continue pour x grand, comme igamc de Cephes utilisé par NIST).
+ */
+inline double randomness_igamc(double a, double x) {
+    if (x <= 0.0 || a <= 0.0) {
+        return 1.0;
+    }
+    if (x < 1.0 || x < a) {
+        return 1.0 - randomness_igam(a, x);
+    }
+    double ax = a * std::log(x) - x - std::lgamma(a);
+    if (ax < -709.78) {
+        return 0.0;
+    }
+    const double big = 4.503599627370496e15;
+    double y = 1.0 - a, z = x + y + 1.0, c = 0.0;
+    double pkm2 = 1.0, qkm2 = x, pkm1 = x + 1.0, qkm1 = z * x;
+    double ans = pkm1 / qkm1, t;
+    do {
+        c += 1.0;
+        y += 1.0;
+        z += 2.0;
+        double yc = y * c;
+        double pk = pkm1 * z - pkm2 * yc;
+        double qk = qkm1 * z - qkm2 * yc;
+        if (qk != 0.0) {
+            double r = pk / qk;
+            t = std::fabs((ans - r) / r);
+            ans = r;
+        } else {
+            t = 1.0;
+        }
+        pkm2 = pkm1;
+        pkm1 = pk;
+        qkm2 = qkm1;
+        qkm1 = qk;
+        if (std::fabs(pk) > big) {
+            pkm2 /= big;
+            pkm1 /= big;
+            qkm2 /= big;
+            qkm1 /= big;
+        }
+    } while (t > 1.11e-16);
+    return ans * std::exp(ax);
+}
+
+// Vue sur une suite de bits (octets, poids fort d'abord)
+struct BitSequence {
+    const uint8_t* bytes;
+    size_t nBits;
+
+    int Bit(size_t i) const {
+        return (bytes[i / 8] >> (7 - i % 8)) & 1;
+    }
+
+    // Nombre de 1 dans [begin, begin + count)
+    uint64_t Ones(size_t begin, size_t count) const {
+        uint64_t ones = 0;
+        size_t i = begin;
+        const size_t end = begin + count;
+        for (; i < end && i % 8 != 0; ++i) {
+            ones += Bit(i);
+        }
+        for (; i + 64 <= end; i += 64) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i / 8, 8);
+            ones += static_cast<uint64_t>(__builtin_popcountll(word));
+        }
+        for (; i < end; ++i) {
+            ones += Bit(i);
+        }
+        return ones;
+    }
+};
+
+/**
+ * @brief Occurrences de chaque motif de m bits, fenêtres chevauchantes sur
+ * la suite refermée en anneau (n fenêtres).
+ */
+inline std::vector<uint64_t> randomness_pattern_counts(const BitSequence& seq, size_t m) {
+    std::vector<uint64_t> counts(size_t(1) << m, 0);
+    const uint32_t mask = static_cast<uint32_t>((uint64_t(1) << m) - 1);
+    uint32_t window = 0;
+    for (size_t i = 0; i + 1 < m; ++i) {
+        window = (window << 1) | static_cast<uint32_t>(seq.Bit(i));
+    }
+    for (size_t i = 0; i < seq.nBits; ++i) {
+        size_t j = i + m - 1;
+        window = ((window << 1) | static_cast<uint32_t>(seq.Bit(j < seq.nBits ? j : j - seq.nBits))) & mask;
+        ++counts[window];
+    }
+    return counts;
+}
+
+// Motifs de m-1 bits : on somme sur le dernier bit des motifs de m bits
+inline std::vector<uint64_t> randomness_shorter_counts(const std::vector<uint64_t>& counts) {
+    std::vector<uint64_t> shorter(counts.size() / 2);
+    for (size_t p = 0; p < shorter.size(); ++p) {
+        shorter[p] = counts[2 * p] + counts[2 * p + 1];
+    }
+    return shorter;
+}
+
+// 1. Fréquence (monobit)
+inline double randomness_monobit(const BitSequence& seq) {
+    double s = 2.0 * static_cast<double>(seq.Ones(0, seq.nBits)) - static_cast<double>(seq.nBits);
+    return std::erfc(std::fabs(s) / std::sqrt(2.0 * seq.nBits));
+}
+
+// 2. Fréquence par blocs de M bits
+inline double randomness_block_frequency(const BitSequence& seq, size_t M) {
+    const size_t N = seq.nBits / M;
+    if (N == 0) {
+        throw std::invalid_argument("randomness_block_frequency: suite plus courte qu'un bloc.");
+    }
+    double chi2 = 0.0;
+    for (size_t b = 0; b < N; ++b) {
+        double pi = static_cast<double>(seq.Ones(b * M, M)) / M - 0.5;
+        chi2 += pi * pi;
+    }
+    chi2 *= 4.0 * M;
+    return randomness_igamc(N / 2.0, chi2 / 2.0);
+}
+
+// 3. Nombre de séries (runs)
+inline double randomness_runs(const BitSequence& seq) {
+    const double n = static_cast<double>(seq.nBits);
+    const double pi = static_cast<double>(seq.Ones(0, seq.nBits)) / n;
+    if (std::fabs(pi - 0.5) >= 2.0 / std::sqrt(n)) {
+        return 0.0; // prérequis de fréquence non satisfait
+    }
+    uint64_t runs = 1;
+    for (size_t i = 0; i + 1 < seq.nBits; ++i) {
+        runs += static_cast<uint64_t>(seq.Bit(i) != seq.Bit(i + 1));
+    }
+    return std::erfc(std::fabs(runs - 2.0 * n * pi * (1.0 - pi)) / (2.0 * std::sqrt(2.0 * n) * pi * (1.0 - pi)));
+}
+
+// 4. Plus longue série de 1 par bloc (paramètres de NIST selon la taille)
+inline double randomness_longest_run(const BitSequence& seq) {
+    size_t M, K;
+    int vMin;
+    const double* pi;
+    static const double pi8[] = {0.21484375, 0.3671875, 0.23046875, 0.1875};
+    static const double pi128[] = {0.1174035788, 0.242955959, 0.249363483, 0.17517706, 0.102701071, 0.112398847};
+    static const double pi10000[] = {0.0882, 0.2092, 0.2483, 0.1933, 0.1208, 0.0675, 0.0727};
+    if (seq.nBits >= 750000) {
+        M = 10000; K = 6; vMin = 10; pi = pi10000;
+    } else if (seq.nBits >= 6272) {
+        M = 128; K = 5; vMin = 4; pi = pi128;
+    } else if (seq.nBits >= 128) {
+        M = 8; K = 3; vMin = 1; pi = pi8;
+    } else {
+        throw std::invalid_argument("randomness_longest_run: au moins 128 bits.");
+    }
+
+    const size_t N = seq.nBits / M;
+    std::vector<uint64_t> v(K + 1, 0);
+    for (size_t b = 0; b < N; ++b) {
+        int longest = 0, current = 0;
+        for (size_t i = b * M; i < (b + 1) * M; ++i) {
+            current = seq.Bit(i) ? current + 1 : 0;
+            longest = std::max(longest, current);
+        }
+        int cls = std::min(std::max(longest, vMin), vMin + static_cast<int>(K)) - vMin;
+        ++v[cls];
+    }
+    double chi2 = 0.0;
+    for (size_t i = 0; i <= K; ++i) {
+        double expected = N * pi[i];
+        chi2 += (v[i] - expected) * (v[i] - expected) / expected;
+    }
+    return randomness_igamc(K / 2.0, chi2 / 2.0);
+}
+
+// psi²_m du test sériel à partir des occurrences des motifs de m bits
+inline double randomness_psi2(const std::vector<uint64_t>& counts, size_t nBits) {
+    double sum = 0.0;
+    for (uint64_t c : counts) {
+        sum += static_cast<double>(c) * c;
+    }
+    return sum * counts.size() / nBits - static_cast<double>(nBits);
+}
+
+// 5. Test sériel (motifs chevauchants de m bits) : deux p-valeurs
+inline void randomness_serial(const BitSequence& seq, size_t m, double& p1, double& p2) {
+    if (m < 3) {
+        throw std::invalid_argument("randomness_serial: m >= 3.");
+    }
+    std::vector<uint64_t> cm = randomness_pattern_counts(seq, m);
+    std::vector<uint64_t> cm1 = randomness_shorter_counts(cm);
+    std::vector<uint64_t> cm2 = randomness_shorter_counts(cm1);
+    double psi_m = randomness_psi2(cm, seq.nBits);
+    double psi_m1 = randomness_psi2(cm1, seq.nBits);
+    double psi_m2 = randomness_psi2(cm2, seq.nBits);
+    p1 = randomness_igamc(std::ldexp(1.0, static_cast<int>(m) - 2), (psi_m - psi_m1) / 2.0);
+    p2 = randomness_igamc(std::ldexp(1.0, static_cast<int>(m) - 3), (psi_m - 2.0 * psi_m1 + psi_m2) / 2.0);
+}
+
+// 6. Entropie approximative (motifs de m et m+1 bits)
+inline double randomness_approximate_entropy(const BitSequence& seq, size_t m) {
+    std::vector<uint64_t> cm1 = randomness_pattern_counts(seq, m + 1);
+    std::vector<uint64_t> cm = randomness_shorter_counts(cm1);
+    auto phi = [&](const std::vector<uint64_t>& counts) {
+        double sum = 0.0;
+        for (uint64_t c : counts) {
+            if (c != 0) {
+                double p = static_cast<double>(c) / seq.nBits;
+                sum += p * std::log(p);
+            }
+        }
+        return sum;
+    };
+    double apen = phi(cm) - phi(cm1);
+    double chi2 = 2.0 * seq.nBits * (std::log(2.0) - apen);
+    return randomness_igamc(std::ldexp(1.0, static_cast<int>(m) - 1), chi2 / 2.0);
+}
+
+// 7. Chi-deux sur l'histogramme des octets (255 degrés de liberté)
+inline double randomness_byte_chi_square(const BitSequence& seq) {
+    const size_t nBytes = seq.nBits / 8;
+    uint64_t counts[256] = {0};
+    for (size_t i = 0; i < nBytes; ++i) {
+        ++counts[seq.bytes[i]];
+    }
+    const double expected = nBytes / 256.0;
+    double chi2 = 0.0;
+    for (uint64_t c : counts) {
+        chi2 += (c - expected) * (c - expected) / expected;
+    }
+    return randomness_igamc(255 / 2.0, chi2 / 2.0);
+}
+
+enum RandomnessTest {
+    RT_MONOBIT,
+    RT_BLOCK_FREQUENCY,
+    RT_RUNS,
+    RT_LONGEST_RUN,
+    RT_SERIAL_1,
+    RT_SERIAL_2,
+    RT_APPROXIMATE_ENTROPY,
+    RT_BYTE_CHI_SQUARE,
+    RT_COUNT
+};
+
+inline const char* randomness_test_name(int test) {
+    static const char* names[RT_COUNT] = {"frequence", "frequence_blocs", "series", "plus_longue_serie",
+                                          "seriel_1", "seriel_2", "entropie_approx", "chi2_octets"};
+    return names[test];
+}
+
+struct RandomnessConfig {
+    uint32_t rule;
+    size_t steps;
+    size_t segments;
+    size_t segmentBits;  // multiple de 256
+};
+
+struct RandomnessTestSummary {
+    size_t passed;        // segments avec p >= RANDOMNESS_ALPHA
+    double minProportion; // proportion minimale attendue (NIST : 1-a - 3 sqrt(a(1-a)/s))
+    double uniformityP;   // uniformité des p-valeurs (chi-deux, 10 classes)
+    double minP;
+
+    bool Passes(size_t segments) const {
+        return passed >= minProportion * segments && uniformityP >= RANDOMNESS_UNIFORMITY_ALPHA;
+    }
+};
+
+struct RandomnessReport {
+    RandomnessConfig config; // rule et steps à 0 pour un autre générateur
+    uint64_t bytesTested;
+    RandomnessTestSummary tests[RT_COUNT];
+    double seconds;
+
+    bool AllPass() const {
+        for (const RandomnessTestSummary& t : tests) {
+            if (!t.Passes(config.segments)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Exécute la batterie sur une suite : p-valeurs indexées par RandomnessTest.
+ */
+inline void randomness_run_battery(const BitSequence& seq, double* pValues) {
+    pValues[RT_MONOBIT] = randomness_monobit(seq);
+    pValues[RT_BLOCK_FREQUENCY] = randomness_block_frequency(seq, std::max<size_t>(20, seq.nBits / 64));
+    pValues[RT_RUNS] = randomness_runs(seq);
+    pValues[RT_LONGEST_RUN] = randomness_longest_run(seq);
+    randomness_serial(seq, RANDOMNESS_SERIAL_M, pValues[RT_SERIAL_1], pValues[RT_SERIAL_2]);
+    pValues[RT_APPROXIMATE_ENTROPY] = randomness_approximate_entropy(seq, RANDOMNESS_APEN_M);
+    pValues[RT_BYTE_CHI_SQUARE] = randomness_byte_chi_square(seq);
+}
+
+class RandomnessSuite {
+private:
+    ThreadPool& _pool;
+
+    // Segment s : hashes des compteurs [s * k, (s + 1) * k), k = segmentBits / 256
+    static void _GenerateSegment(const RandomnessConfig& config, size_t segment, std::vector<uint8_t>& states,
+                                 std::vector<uint8_t>& output) {
+        const size_t nDigests = config.segmentBits / HASH_SIZE_BITS;
+        uint8_t (*initial)[HASH_SIZE_BYTES] = reinterpret_cast<uint8_t (*)[HASH_SIZE_BYTES]>(states.data());
+        for (size_t k = 0; k < nDigests; ++k) {
+            uint8_t counter[8];
+            uint64_t value = static_cast<uint64_t>(segment) * nDigests + k;
+            for (int i = 0; i < 8; ++i) {
+                counter[i] = static_cast<uint8_t>(value >> (8 * i));
+            }
+            string_to_bytes(counter, sizeof(counter), initial[k], HASH_SIZE_BYTES);
+        }
+        ac_evolve_batch(initial, nDigests, config.rule, config.steps,
+                        reinterpret_cast<uint8_t (*)[HASH_SIZE_BYTES]>(output.data()));
+    }
+
+public:
+    explicit RandomnessSuite(ThreadPool& pool) : _pool(pool) {}
+
+    /**
+     * @brief Teste le flux ac_hash(rule, steps) des compteurs.
+     */
+    RandomnessReport Run(const RandomnessConfig& config) {
+        return RunGenerator(config, [&](size_t segment, std::vector<uint8_t>& states, std::vector<uint8_t>& output) {
+            _GenerateSegment(config, segment, states, output);
+        });
+    }
+
+    /**
+     * @brief Teste un autre générateur (témoin) : generate(segment, scratch,
+     * output) remplit 'output' (segmentBits / 8 octets) ; 'scratch' est un
+     * buffer de même taille propre au thread.
+     */
+    template <class Generate>
+    RandomnessReport RunGenerator(const RandomnessConfig& config, Generate generate) {
+        if (config.segments == 0 || config.segmentBits < 6272 || config.segmentBits % HASH_SIZE_BITS != 0) {
+            throw std::invalid_argument("RandomnessSuite: segments de 6272 bits minimum, multiples de 256.");
+        }
+        auto t_start = std::chrono::steady_clock::now();
+
+        std::vector<double> pValues(config.segments * RT_COUNT);
+        std::atomic<size_t> next(0);
+        _pool.RunOnAll([&](unsigned) {
+            std::vector<uint8_t> scratch(config.segmentBits / 8);
+            std::vector<uint8_t> output(config.segmentBits / 8);
+            for (;;) {
+                size_t segment = next.fetch_add(1, std::memory_order_relaxed);
+                if (segment >= config.segments) {
+                    return;
+                }
+                generate(segment, scratch, output);
+                randomness_run_battery(BitSequence{output.data(), config.segmentBits},
+                                       pValues.data() + segment * RT_COUNT);
+            }
+        });
+
+        RandomnessReport report;
+        report.config = config;
+        report.bytesTested = static_cast<uint64_t>(config.segments) * config.segmentBits / 8;
+        const double s = static_cast<double>(config.segments);
+        for (int test = 0; test < RT_COUNT; ++test) {
+            RandomnessTestSummary& summary = report.tests[test];
+            summary.passed = 0;
+            summary.minP = 1.0;
+            summary.minProportion = (1.0 - RANDOMNESS_ALPHA) - 3.0 * std::sqrt(RANDOMNESS_ALPHA * (1.0 - RANDOMNESS_ALPHA) / s);
+            uint64_t bins[10] = {0};
+            for (size_t seg = 0; seg < config.segments; ++seg) {
+                double p = pValues[seg * RT_COUNT + test];
+                summary.passed += (p >= RANDOMNESS_ALPHA) ? 1 : 0;
+                summary.minP = std::min(summary.minP, p);
+                ++bins[std::min(9, static_cast<int>(p * 10.0))];
+            }
+            double chi2 = 0.0;
+            for (uint64_t b : bins) {
+                chi2 += (b - s / 10.0) * (b - s / 10.0) / (s / 10.0);
+            }
+            summary.uniformityP = randomness_igamc(9 / 2.0, chi2 / 2.0);
+        }
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+        return report;
+    }
+};
+
+#endif // RANDOMNESS_TESTS_HPP
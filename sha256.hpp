@@ -5,29 +5,56 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <cstdint>
 
 class SHA256 {
 public:
     SHA256();
+    void reset();
     void update(const uint8_t* data, size_t length);
     void update(const std::string& data);
-    uint8_t* digest();
+    // Finalise le hash. Pas de buffer statique : sûr entre threads.
+    // Pour réutiliser le contexte (nonce suivant), appeler reset().
+    void digest(uint8_t* out);
+    std::array<uint8_t, 32> digest();
     static std::string toString(const uint8_t* digest);
+    static std::string toString(const std::array<uint8_t, 32>& digest);
 
 private:
-    void transform(const uint8_t* message, unsigned int block_nb);
+    void transform(const uint8_t* message, size_t block_nb);
     uint32_t m_h[8];
     uint8_t m_block[64];
     unsigned int m_len;
+    uint64_t m_tot_len; // octets deja compresses (blocs complets)
 };
 
 std::string sha256(const std::string& input);
+std::array<uint8_t, 32> sha256_raw(const uint8_t* data, size_t length);
+std::array<uint8_t, 32> sha256_raw(const std::string& input);
+
+// Backends de la fonction de compression, choisis a l'execution
+enum class Sha256Backend {
+    SCALAR,  // code C portable (reference)
+    SHANI,   // instructions x86 SHA (SHA-NI)
+    AVX2_X8  // 8 messages en parallele (multi-buffer), pour sha256_batch()
+};
+
+const char* sha256_backend_name(Sha256Backend backend);
+bool sha256_backend_supported(Sha256Backend backend);
+Sha256Backend sha256_active_backend();
+void sha256_batch(const std::string* inputs, size_t n, uint8_t (*out)[32]);
+void sha256_batch(const std::string* inputs, size_t n, uint8_t (*out)[32], Sha256Backend backend);
 
 #include <cstring>
 #include <sstream>
 #include <iomanip>
 
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SHA256_HAS_X86_BACKENDS 1
+#include <immintrin.h>
+#endif
+
 #define ROTLEFT(a,b) (((a) << (b)) | ((a) >> (32-(b))))
 #define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
 
@@ -49,23 +76,17 @@ static const uint32_t k[64] = {
     0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 };
 
-SHA256::SHA256() {
-    m_h[0] = 0x6a09e667;
-    m_h[1] = 0xbb67ae85;
-    m_h[2] = 0x3c6ef372;
-    m_h[3] = 0xa54ff53a;
-    m_h[4] = 0x510e527f;
-    m_h[5] = 0x9b05688c;
-    m_h[6] = 0x1f83d9ab;
-    m_h[7] = 0x5be0cd19;
-    m_len = 0;
-}
+// ============================================================================
+// --- Backends de compression ---
+// ============================================================================
+// Tous les backends calculent exactement la meme fonction de compression que
+// le code scalaire ; seul le moyen change. 'state' = m_h (8 mots).
 
-void SHA256::transform(const uint8_t* message, unsigned int block_nb) {
+static void sha256_transform_scalar(uint32_t* state, const uint8_t* message, size_t block_nb) {
     uint32_t w[64];
     uint32_t a, b, c, d, e, f, g, h;
 
-    for (unsigned int i = 0; i < block_nb; i++) {
+    for (size_t i = 0; i < block_nb; i++) {
         for (unsigned int j = 0; j < 16; j++) {
             w[j] = (message[i * 64 + j * 4] << 24) | (message[i * 64 + j * 4 + 1] << 16) | (message[i * 64 + j * 4 + 2] << 8) | (message[i * 64 + j * 4 + 3]);
         }
@@ -73,8 +94,8 @@ void SHA256::transform(const uint8_t* message, unsigned int block_nb) {
             w[j] = SIG1(w[j - 2]) + w[j - 7] + SIG0(w[j - 15]) + w[j - 16];
         }
 
-        a = m_h[0]; b = m_h[1]; c = m_h[2]; d = m_h[3];
-        e = m_h[4]; f = m_h[5]; g = m_h[6]; h = m_h[7];
+        a = state[0]; b = state[1]; c = state[2]; d = state[3];
+        e = state[4]; f = state[5]; g = state[6]; h = state[7];
 
         for (unsigned int j = 0; j < 64; j++) {
             uint32_t t1 = h + EP1(e) + CH(e, f, g) + k[j] + w[j];
@@ -83,29 +104,222 @@ void SHA256::transform(const uint8_t* message, unsigned int block_nb) {
             d = c; c = b; b = a; a = t1 + t2;
         }
 
-        m_h[0] += a; m_h[1] += b; m_h[2] += c; m_h[3] += d;
-        m_h[4] += e; m_h[5] += f; m_h[6] += g; m_h[7] += h;
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+#if defined(SHA256_HAS_X86_BACKENDS)
+// SHA-NI : sha256rnds2 fait 2 rondes, sha256msg1/msg2 etendent le message.
+// L'etat est range en ABEF / CDGH comme l'attendent les instructions.
+__attribute__((target("sha,sse4.1")))
+static void sha256_transform_shani(uint32_t* state, const uint8_t* message, size_t block_nb) {
+    const __m128i BSWAP = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);            // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);      // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);   // CDGH
+
+    for (size_t i = 0; i < block_nb; i++) {
+        const __m128i abef_save = state0;
+        const __m128i cdgh_save = state1;
+        __m128i w[4];
+
+        for (int g = 0; g < 16; g++) { // 16 groupes de 4 rondes
+            if (g < 4) {
+                w[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(message + i * 64 + g * 16)), BSWAP);
+            } else {
+                // w[g] = sigma1(...) + w[g-7] + sigma0(...) + w[g-16], 4 mots a la fois
+                __m128i x = _mm_sha256msg1_epu32(w[g & 3], w[(g + 1) & 3]);
+                x = _mm_add_epi32(x, _mm_alignr_epi8(w[(g + 3) & 3], w[(g + 2) & 3], 4));
+                w[g & 3] = _mm_sha256msg2_epu32(x, w[(g + 3) & 3]);
+            }
+            __m128i msg = _mm_add_epi32(w[g & 3], _mm_loadu_si128(reinterpret_cast<const __m128i*>(&k[g * 4])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
     }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);         // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);      // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);   // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);      // ABEF -> HGFE
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+// AVX2 multi-buffer : 8 messages independants, un par voie de 32 bits.
+// states[j][lane] = mot j de l'etat du message 'lane' ; blocks[lane] = son bloc de 64 octets.
+typedef uint32_t sha256_v8u32 __attribute__((vector_size(32)));
+
+__attribute__((target("avx2")))
+static void sha256_transform_x8(uint32_t states[8][8], const uint8_t* const blocks[8]) {
+#define V8_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+    sha256_v8u32 w[64];
+    sha256_v8u32 s[8];
+
+    for (int j = 0; j < 16; j++) {
+        for (int lane = 0; lane < 8; lane++) {
+            const uint8_t* p = blocks[lane] + j * 4;
+            w[j][lane] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+        }
+    }
+    for (int j = 16; j < 64; j++) {
+        sha256_v8u32 s0 = V8_ROTR(w[j - 15], 7) ^ V8_ROTR(w[j - 15], 18) ^ (w[j - 15] >> 3);
+        sha256_v8u32 s1 = V8_ROTR(w[j - 2], 17) ^ V8_ROTR(w[j - 2], 19) ^ (w[j - 2] >> 10);
+        w[j] = s1 + w[j - 7] + s0 + w[j - 16];
+    }
+
+    for (int j = 0; j < 8; j++) {
+        for (int lane = 0; lane < 8; lane++) {
+            s[j][lane] = states[j][lane];
+        }
+    }
+    sha256_v8u32 a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (int j = 0; j < 64; j++) {
+        sha256_v8u32 ep1 = V8_ROTR(e, 6) ^ V8_ROTR(e, 11) ^ V8_ROTR(e, 25);
+        sha256_v8u32 ch = (e & f) ^ (~e & g);
+        sha256_v8u32 t1 = h + ep1 + ch + k[j] + w[j];
+        sha256_v8u32 ep0 = V8_ROTR(a, 2) ^ V8_ROTR(a, 13) ^ V8_ROTR(a, 22);
+        sha256_v8u32 maj = (a & b) ^ (a & c) ^ (b & c);
+        sha256_v8u32 t2 = ep0 + maj;
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+    s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+    for (int j = 0; j < 8; j++) {
+        for (int lane = 0; lane < 8; lane++) {
+            states[j][lane] = s[j][lane];
+        }
+    }
+#undef V8_ROTR
+}
+#endif // SHA256_HAS_X86_BACKENDS
+
+bool sha256_backend_supported(Sha256Backend backend) {
+#if defined(SHA256_HAS_X86_BACKENDS)
+    __builtin_cpu_init(); // peut etre appele depuis un initialiseur statique
+#endif
+    switch (backend) {
+        case Sha256Backend::SCALAR:
+            return true;
+#if defined(SHA256_HAS_X86_BACKENDS)
+        case Sha256Backend::SHANI:
+            return __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+        case Sha256Backend::AVX2_X8:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* sha256_backend_name(Sha256Backend backend) {
+    switch (backend) {
+        case Sha256Backend::SHANI:   return "SHA-NI";
+        case Sha256Backend::AVX2_X8: return "AVX2 x8";
+        case Sha256Backend::SCALAR:  default: return "scalaire";
+    }
+}
+
+// Backend des messages isoles : SHA-NI si le CPU l'a, sinon le code scalaire.
+// (Le multi-buffer AVX2 ne sert qu'aux lots, voir sha256_batch().)
+Sha256Backend sha256_active_backend() {
+    static const Sha256Backend active = sha256_backend_supported(Sha256Backend::SHANI)
+        ? Sha256Backend::SHANI : Sha256Backend::SCALAR;
+    return active;
+}
+
+typedef void (*sha256_transform_fn)(uint32_t*, const uint8_t*, size_t);
+
+static sha256_transform_fn sha256_select_transform() {
+#if defined(SHA256_HAS_X86_BACKENDS)
+    if (sha256_active_backend() == Sha256Backend::SHANI) {
+        return sha256_transform_shani;
+    }
+#endif
+    return sha256_transform_scalar;
+}
+
+// Detection faite une seule fois, au premier hachage (statique locale : utilisable
+// pendant l'initialisation statique d'une autre unite de traduction).
+static sha256_transform_fn sha256_transform_impl() {
+    static const sha256_transform_fn impl = sha256_select_transform();
+    return impl;
+}
+// ============================================================================
+// --- FIN Backends ---
+// ============================================================================
+
+SHA256::SHA256() {
+    reset();
+}
+
+void SHA256::reset() {
+    m_h[0] = 0x6a09e667;
+    m_h[1] = 0xbb67ae85;
+    m_h[2] = 0x3c6ef372;
+    m_h[3] = 0xa54ff53a;
+    m_h[4] = 0x510e527f;
+    m_h[5] = 0x9b05688c;
+    m_h[6] = 0x1f83d9ab;
+    m_h[7] = 0x5be0cd19;
+    m_len = 0;
+    m_tot_len = 0;
+}
+
+void SHA256::transform(const uint8_t* message, size_t block_nb) {
+    sha256_transform_impl()(m_h, message, block_nb);
+    m_tot_len += static_cast<uint64_t>(block_nb) * 64;
 }
 
 void SHA256::update(const uint8_t* data, size_t length) {
-    for (size_t i = 0; i < length; i++) {
-        m_block[m_len++] = data[i];
-        if (m_len == 64) {
-            transform(m_block, 1);
-            m_len = 0;
+    // 1. Complete le bloc partiel laisse par l'appel precedent
+    if (m_len > 0) {
+        size_t take = (length < 64 - m_len) ? length : 64 - m_len;
+        memcpy(m_block + m_len, data, take);
+        m_len += take;
+        data += take;
+        length -= take;
+        if (m_len < 64) {
+            return;
         }
+        transform(m_block, 1);
+        m_len = 0;
+    }
+
+    // 2. Tous les blocs complets partent directement de la memoire de
+    //    l'appelant, en un seul appel multi-blocs (pas de copie)
+    size_t block_nb = length / 64;
+    if (block_nb > 0) {
+        transform(data, block_nb);
+        data += block_nb * 64;
+        length -= block_nb * 64;
     }
+
+    // 3. Seule la fin (< 64 octets) est mise en tampon
+    memcpy(m_block, data, length);
+    m_len = static_cast<unsigned int>(length);
 }
 
 void SHA256::update(const std::string& data) {
     update(reinterpret_cast<const uint8_t*>(data.c_str()), data.size());
 }
 
-uint8_t* SHA256::digest() {
-    static uint8_t hash[32];
+void SHA256::digest(uint8_t* hash) {
     unsigned int i;
-    uint64_t L = m_len * 8;
+    // Taille totale du message en bits (blocs deja compresses + reste du buffer)
+    uint64_t L = (m_tot_len + m_len) * 8;
 
     m_block[m_len++] = 0x80;
     if (m_len > 56) {
@@ -126,6 +340,11 @@ uint8_t* SHA256::digest() {
         hash[i * 4 + 2] = (m_h[i] >> 8) & 0xff;
         hash[i * 4 + 3] = m_h[i] & 0xff;
     }
+}
+
+std::array<uint8_t, 32> SHA256::digest() {
+    std::array<uint8_t, 32> hash;
+    digest(hash.data());
     return hash;
 }
 
@@ -138,10 +357,163 @@ std::string SHA256::toString(const uint8_t* digest) {
     return ss.str();
 }
 
+std::string SHA256::toString(const std::array<uint8_t, 32>& digest) {
+    return toString(digest.data());
+}
+
 std::string sha256(const std::string& input) {
     SHA256 sha;
     sha.update(input);
     return SHA256::toString(sha.digest());
 }
 
+// Hash binaire : pas de chaine hexadecimale a allouer (boucles de minage/validation).
+std::array<uint8_t, 32> sha256_raw(const uint8_t* data, size_t length) {
+    SHA256 sha;
+    sha.update(data, length);
+    return sha.digest();
+}
+
+std::array<uint8_t, 32> sha256_raw(const std::string& input) {
+    return sha256_raw(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+}
+
+static const uint32_t sha256_h0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// Prepare le(s) dernier(s) bloc(s) d'un message : fin du message, 0x80, zeros,
+// taille en bits. Retourne le nombre de blocs de 'tail' (1 ou 2).
+static size_t sha256_pad_tail(const uint8_t* msg, size_t len, uint8_t tail[128]) {
+    size_t rest = len % 64;
+    size_t tail_blocks = (rest + 9 > 64) ? 2 : 1;
+    memset(tail, 0, 128);
+    memcpy(tail, msg + len - rest, rest);
+    tail[rest] = 0x80;
+    uint64_t L = static_cast<uint64_t>(len) * 8;
+    for (int i = 0; i < 8; i++) {
+        tail[tail_blocks * 64 - 1 - i] = (L >> (i * 8)) & 0xff;
+    }
+    return tail_blocks;
+}
+
+static void sha256_store_digest(const uint32_t* state, uint8_t* out) {
+    for (int j = 0; j < 8; j++) {
+        out[j * 4] = (state[j] >> 24) & 0xff;
+        out[j * 4 + 1] = (state[j] >> 16) & 0xff;
+        out[j * 4 + 2] = (state[j] >> 8) & 0xff;
+        out[j * 4 + 3] = state[j] & 0xff;
+    }
+}
+
+/**
+ * Hache 'n' messages independants ; out[i] = SHA-256 de inputs[i].
+ * Avec AVX2_X8, 8 messages avancent ensemble, bloc par bloc. Un message plus
+ * court que les autres garde son etat final pendant que les autres finissent.
+ */
+void sha256_batch(const std::string* inputs, size_t n, uint8_t (*out)[32], Sha256Backend backend) {
+    if (!sha256_backend_supported(backend)) {
+        backend = Sha256Backend::SCALAR;
+    }
+
+#if defined(SHA256_HAS_X86_BACKENDS)
+    if (backend == Sha256Backend::AVX2_X8) {
+        static const uint8_t ZERO_BLOCK[64] = {0};
+
+        for (size_t base = 0; base < n; base += 8) {
+            size_t count = (n - base < 8) ? (n - base) : 8;
+            uint32_t states[8][8];
+            uint8_t tails[8][128]; // dernier(s) bloc(s) : fin du message + remplissage
+            size_t full_blocks[8];
+            size_t total_blocks[8];
+            size_t max_blocks = 0;
+
+            for (size_t lane = 0; lane < 8; lane++) {
+                for (int j = 0; j < 8; j++) {
+                    states[j][lane] = sha256_h0[j];
+                }
+                full_blocks[lane] = 0;
+                total_blocks[lane] = 0;
+                if (lane >= count) {
+                    continue;
+                }
+
+                const std::string& msg = inputs[base + lane];
+                full_blocks[lane] = msg.size() / 64;
+                total_blocks[lane] = full_blocks[lane]
+                    + sha256_pad_tail(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(), tails[lane]);
+                if (total_blocks[lane] > max_blocks) {
+                    max_blocks = total_blocks[lane];
+                }
+            }
+
+            for (size_t blk = 0; blk < max_blocks; blk++) {
+                const uint8_t* blocks[8];
+                uint32_t saved[8][8];
+                for (size_t lane = 0; lane < 8; lane++) {
+                    if (blk < full_blocks[lane]) {
+                        blocks[lane] = reinterpret_cast<const uint8_t*>(inputs[base + lane].data()) + blk * 64;
+                    } else if (blk < total_blocks[lane]) {
+                        blocks[lane] = tails[lane] + (blk - full_blocks[lane]) * 64;
+                    } else {
+                        blocks[lane] = ZERO_BLOCK; // voie terminee : resultat ignore
+                    }
+                    for (int j = 0; j < 8; j++) {
+                        saved[j][lane] = states[j][lane];
+                    }
+                }
+
+                sha256_transform_x8(states, blocks);
+
+                for (size_t lane = 0; lane < 8; lane++) {
+                    if (blk >= total_blocks[lane]) {
+                        for (int j = 0; j < 8; j++) {
+                            states[j][lane] = saved[j][lane];
+                        }
+                    }
+                }
+            }
+
+            for (size_t lane = 0; lane < count; lane++) {
+                uint32_t state[8];
+                for (int j = 0; j < 8; j++) {
+                    state[j] = states[j][lane];
+                }
+                sha256_store_digest(state, out[base + lane]);
+            }
+        }
+        return;
+    }
+#endif
+
+    // SCALAR / SHANI : un message a la fois, avec le backend demande
+    sha256_transform_fn transform = sha256_transform_scalar;
+#if defined(SHA256_HAS_X86_BACKENDS)
+    if (backend == Sha256Backend::SHANI) {
+        transform = sha256_transform_shani;
+    }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t* msg = reinterpret_cast<const uint8_t*>(inputs[i].data());
+        size_t len = inputs[i].size();
+        uint8_t tail[128];
+        uint32_t state[8];
+        memcpy(state, sha256_h0, sizeof(state));
+        transform(state, msg, len / 64);
+        transform(state, tail, sha256_pad_tail(msg, len, tail));
+        sha256_store_digest(state, out[i]);
+    }
+}
+
+void sha256_batch(const std::string* inputs, size_t n, uint8_t (*out)[32]) {
+    // SHA-NI sur un seul message bat le multi-buffer AVX2 ; sinon AVX2 x8.
+    Sha256Backend backend = Sha256Backend::SCALAR;
+    if (sha256_active_backend() == Sha256Backend::SHANI) {
+        backend = Sha256Backend::SHANI;
+    } else if (sha256_backend_supported(Sha256Backend::AVX2_X8)) {
+        backend = Sha256Backend::AVX2_X8;
+    }
+    sha256_batch(inputs, n, out, backend);
+}
+
 #endif
\ No newline at end of file
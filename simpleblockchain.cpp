@@ -1,56 +1,118 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <chrono>
 #include <ctime>
-#include <numeric> // Pour std::accumulate
-#include <random>  // Pour la sélection aléatoire
+#include <cstring>
+#include <charconv>
+#include <type_traits>
+#include <cmath>
+#include <algorithm>
+#include <random>
 #include "sha256.hpp"
-
-// Structure simple pour représenter un validateur
-struct Validator {
-    std::string address;
-    double stake;
-};
+#include "block_hash.hpp" // Hash256 + comparaison binaire à la difficulté
+#include "parallel_miner.hpp" // Recherche de nonce multithread
+#include "validator_registry.hpp" // Sélection PoS pondérée en O(log n)
+#include "block_arena.hpp" // Données des blocs et adresses des validateurs possédées par la chaîne
 
 // --- Classe Block (légèrement modifiée pour PoS) ---
+// Aucune allocation propre : les données sont une vue dans l'arène de la
+// chaîne et le validateur un identifiant de son StringPool. Le bloc n'est que
+// déplaçable, pour que l'insertion dans la chaîne ne puisse pas copier.
 class Block {
 private:
     uint32_t _nIndex;
-    std::string _sData;
+    uint32_t _nValidatorId; // NO_VALIDATOR tant que le bloc n'est pas validé
     time_t _tTime;
-    std::string _sValidatorAddress; // Adresse du validateur choisi
+    std::string_view _svData;
+    bool _bHashed;     // hash calculé (ValidateBlock / MineBlock)
+    bool _bPrevHashed; // le prédécesseur avait un hash quand il a été lié (SetPrevious)
 
-    // Fonction de hachage privée
-    std::string _CalculateHash() const {
-        std::string ss = std::to_string(_nIndex) + std::to_string(_tTime) + _sData + sPrevHash + _sValidatorAddress;
-        return sha256(ss);
+    // Partie commune de la préimage. Le hash précédent y figure en hexadécimal,
+    // sauf si le prédécesseur n'a jamais été haché (le Genesis de cette
+    // simulation) : chaîne vide, comme l'ancien sPrevHash jamais renseigné.
+    std::string _BasePreimage() const {
+        std::string preimage = std::to_string(_nIndex) + std::to_string(_tTime);
+        preimage.append(_svData.data(), _svData.size());
+        return _bPrevHashed ? preimage + hash_to_hex(prevHash) : preimage;
+    }
+
+    // Même préimage que _BasePreimage() + adresse, absorbée morceau par morceau (sans allocation)
+    Hash256 _CalculateHash(std::string_view validatorAddress) const {
+        char digits[20];
+        char hex[64];
+        SHA256 sha;
+        char* end = std::to_chars(digits, digits + sizeof(digits), _nIndex).ptr;
+        sha.update(reinterpret_cast<const uint8_t*>(digits), end - digits);
+        end = std::to_chars(digits, digits + sizeof(digits), static_cast<int64_t>(_tTime)).ptr;
+        sha.update(reinterpret_cast<const uint8_t*>(digits), end - digits);
+        sha.update(reinterpret_cast<const uint8_t*>(_svData.data()), _svData.size());
+        if (_bPrevHashed) { // voir _BasePreimage()
+            hash_to_hex(prevHash, hex);
+            sha.update(reinterpret_cast<const uint8_t*>(hex), sizeof(hex));
+        }
+        sha.update(reinterpret_cast<const uint8_t*>(validatorAddress.data()), validatorAddress.size());
+        return sha.digest();
     }
 
 public:
-    std::string sPrevHash;
-    std::string sHash;
+    static const uint32_t NO_VALIDATOR = UINT32_MAX;
+
+    // Hashes binaires (32 octets), convertis en hexadécimal seulement pour l'affichage
+    Hash256 prevHash;
+    Hash256 hash;
+
+    // svDataIn doit rester valide aussi longtemps que le bloc (arène de la chaîne)
+    Block(uint32_t nIndexIn, std::string_view svDataIn)
+        : _nIndex(nIndexIn), _nValidatorId(NO_VALIDATOR), _tTime(time(nullptr)), _svData(svDataIn),
+          _bHashed(false), _bPrevHashed(false), prevHash(), hash() {
+    }
+
+    Block(const Block&) = delete;
+    Block& operator=(const Block&) = delete;
+    Block(Block&&) = default;
+    Block& operator=(Block&&) = default;
+
+    uint32_t GetIndex() const { return _nIndex; }
+    time_t GetTime() const { return _tTime; }
+    std::string_view GetData() const { return _svData; }
+    uint32_t GetValidatorId() const { return _nValidatorId; }
 
-    Block(uint32_t nIndexIn, const std::string &sDataIn) : _nIndex(nIndexIn), _sData(sDataIn) {
-        _tTime = time(nullptr);
+    // Lie le bloc à son prédécesseur (avant ValidateBlock / MineBlock)
+    void SetPrevious(const Block& previous) {
+        prevHash = previous.hash;
+        _bPrevHashed = previous._bHashed;
     }
 
     // Fonction de validation PoS (remplace le minage PoW)
-    void ValidateBlock(const std::string& validatorAddress) {
-        _sValidatorAddress = validatorAddress;
-        sHash = _CalculateHash();
+    void ValidateBlock(uint32_t validatorId, std::string_view validatorAddress) {
+        _nValidatorId = validatorId;
+        hash = _CalculateHash(validatorAddress);
+        _bHashed = true;
+    }
+
+    bool HasValidHash(std::string_view validatorAddress) const {
+        return hash == _CalculateHash(validatorAddress);
     }
 
     // --- Fonction de minage PoW (gardée pour la comparaison) ---
     void MineBlock(uint32_t nDifficulty) {
-        std::string str(nDifficulty, '0');
         int64_t nNonce = 0;
+        NonceHasher hasher(HashMethod::SHA256, _BasePreimage());
         
         do {
             nNonce++;
-            std::string ss = std::to_string(_nIndex) + std::to_string(_tTime) + _sData + sPrevHash + std::to_string(nNonce);
-            sHash = sha256(ss);
-        } while (sHash.substr(0, nDifficulty) != str);
+            hasher(nNonce, hash);
+        } while (!hash_meets_difficulty(hash, nDifficulty));
+        _bHashed = true;
+    }
+
+    // Variante multithread (même nonce que la version séquentielle)
+    void MineBlock(uint32_t nDifficulty, ParallelMiner& miner) {
+        const std::string base = _BasePreimage();
+        hash = miner.Mine([&] { return NonceHasher(HashMethod::SHA256, base); }, nDifficulty).hash;
+        _bHashed = true;
     }
 };
 
@@ -58,70 +120,237 @@ public:
 // Classe Blockchain
 class Blockchain {
 private:
+    PayloadArena _payloads;       // Données des blocs (déclarée avant _vChain : lui survit)
+    // Adresses internées : les blocs n'en gardent que l'identifiant 32 bits. Le
+    // registre garde sa propre copie (Validator::address) : deux copies par
+    // validateur, aucune par bloc.
+    StringPool _validatorNames;
+    std::vector<uint32_t> _vValidatorIds; // index du registre -> identifiant dans _validatorNames
     std::vector<Block> _vChain;
-    std::vector<Validator> _vValidators;
+    ValidatorRegistry _validators; // Validateurs PoS + générateur aléatoire
+    ThreadPool _pool;     // Pool de threads de minage (un par coeur)
+    ParallelMiner _miner;
+    bool _bVerbose;
 
     const Block& _GetLastBlock() const {
         return _vChain.back();
     }
 
-    // sélection du validateur 
-    Validator& SelectValidator() {
-        double totalStake = 0.0;
-        for (const auto& v : _vValidators) {
-            totalStake += v.stake;
-        }
+public:
+    Blockchain() : _pool(), _miner(_pool), _bVerbose(true) {
+        _vChain.emplace_back(0, _payloads.Store("Genesis Block"));
+    }
 
-        // Générer un nombre aléatoire entre 0 et totalStake
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> distrib(0, totalStake);
-        double randomPoint = distrib(gen);
-
-        double currentSum = 0.0;
-        for (auto& v : _vValidators) {
-            currentSum += v.stake;
-            if (randomPoint <= currentSum) {
-                return v;
-            }
-        }
-        // En cas d'erreur de virgule flottante, retourner le dernier
-        return _vValidators.back();
+    // Ajouter des validateurs au réseau
+    void AddValidator(const std::string& address, double stake) {
+        _validators.Add(address, stake);
+        _vValidatorIds.push_back(_validatorNames.Intern(address));
     }
 
+    void SetVerbose(bool bVerbose) {
+        _bVerbose = bVerbose;
+    }
 
-public:
-    Blockchain() {
-        _vChain.emplace_back(Block(0, "Genesis Block"));
+    // Réserve la place de nBlocks blocs supplémentaires (plus de réallocation de _vChain)
+    void Reserve(size_t nBlocks) {
+        _vChain.reserve(_vChain.size() + nBlocks);
     }
 
-    // Ajouter des validateurs au réseau
-    void AddValidator(const std::string& address, double stake) {
-        _vValidators.push_back({address, stake});
+    size_t Capacity() const {
+        return _vChain.capacity();
+    }
+
+    size_t Size() const {
+        return _vChain.size();
+    }
+
+    const PayloadArena& Payloads() const {
+        return _payloads;
     }
 
-    // Ajout d'un bloc avec PoS
-    void AddBlockPoS(Block bNew) {
-        if (_vValidators.empty()) {
+    // Ajout d'un bloc avec PoS ; sData est copiée dans l'arène de la chaîne
+    void AddBlockPoS(std::string_view sData) {
+        if (_validators.Empty()) {
             std::cout << "Erreur: Aucun validateur dans le reseau !" << std::endl;
             return;
         }
-        Validator& chosenValidator = SelectValidator();
-        std::cout << "Validateur choisi: " << chosenValidator.address << " (Enjeu: " << chosenValidator.stake << ")" << std::endl;
-        
-        bNew.sPrevHash = _GetLastBlock().sHash;
-        bNew.ValidateBlock(chosenValidator.address);
-        _vChain.push_back(bNew);
+        size_t chosenIndex = _validators.SelectIndex();
+        if (_bVerbose) {
+            const Validator& chosenValidator = _validators[chosenIndex];
+            std::cout << "Validateur choisi: " << chosenValidator.address << " (Enjeu: " << chosenValidator.stake << ")" << std::endl;
+        }
+
+        Block bNew(static_cast<uint32_t>(_vChain.size()), _payloads.Store(sData));
+        bNew.SetPrevious(_GetLastBlock());
+        uint32_t validatorId = _vValidatorIds[chosenIndex];
+        bNew.ValidateBlock(validatorId, _validatorNames.Get(validatorId));
+        _vChain.push_back(std::move(bNew));
     }
 
     // Ajout d'un bloc avec PoW (pour la comparaison)
-    void AddBlockPoW(Block bNew, uint32_t difficulty) {
-        bNew.sPrevHash = _GetLastBlock().sHash;
-        bNew.MineBlock(difficulty);
-        _vChain.push_back(bNew);
+    void AddBlockPoW(std::string_view sData, uint32_t difficulty) {
+        Block bNew(static_cast<uint32_t>(_vChain.size()), _payloads.Store(sData));
+        bNew.SetPrevious(_GetLastBlock());
+        bNew.MineBlock(difficulty, _miner);
+        _vChain.push_back(std::move(bNew));
+    }
+
+    /**
+     * @brief Vérifie le chaînage et le hash des blocs PoS (validateur connu).
+     */
+    bool IsValidPoS() const {
+        for (size_t i = 1; i < _vChain.size(); ++i) {
+            const Block& block = _vChain[i];
+            if (block.prevHash != _vChain[i - 1].hash || block.GetValidatorId() == Block::NO_VALIDATOR ||
+                !block.HasValidHash(_validatorNames.Get(block.GetValidatorId()))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const Block& GetBlock(size_t height) const {
+        return _vChain.at(height);
+    }
+
+    std::string_view ValidatorOf(size_t height) const {
+        return _validatorNames.Get(_vChain.at(height).GetValidatorId());
     }
 };
 
+/**
+ * @brief Ajoute nBlocks blocs PoS sans affichage et compte les allocations de
+ * la chaîne (tranches de l'arène, réallocation du vecteur des blocs) ; vérifie
+ * aussi que le hash calculé sans allocation est celui de l'ancienne préimage texte.
+ */
+bool run_allocation_check(size_t nBlocks) {
+    Blockchain chain;
+    chain.AddValidator("Alice", 100);
+    chain.AddValidator("Bob", 50);
+    chain.AddValidator("Charlie", 250);
+    chain.AddValidator("David", 20);
+    chain.SetVerbose(false);
+    chain.Reserve(nBlocks);
+
+    char sData[32] = "Transaction Data PoS ";
+    const size_t nPrefix = std::strlen(sData);
+
+    // Un Block ne possède rien sur le tas : ses seules allocations sont les
+    // tranches de l'arène et les réallocations du vecteur de la chaîne.
+    static_assert(std::is_trivially_destructible<Block>::value, "Block ne doit posseder aucune allocation");
+    const size_t nChunksBefore = chain.Payloads().ChunkCount();
+    const size_t nCapacity = chain.Capacity();
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < nBlocks; ++i) {
+        char* end = std::to_chars(sData + nPrefix, sData + sizeof(sData), i).ptr;
+        chain.AddBlockPoS(std::string_view(sData, end - sData));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const size_t nChunks = chain.Payloads().ChunkCount() - nChunksBefore;
+    const bool bNoRealloc = chain.Capacity() == nCapacity;
+
+    std::cout << nBlocks << " blocs PoS en " << seconds << " s (" << nBlocks / seconds << " blocs/s)" << std::endl;
+    std::cout << "Allocations de la chaine : " << nChunks << " tranches d'arene ("
+              << static_cast<double>(nChunks) / nBlocks << " par bloc, " << chain.Payloads().Bytes()
+              << " octets), vecteur des blocs " << (bNoRealloc ? "non realloue" : "realloue") << std::endl;
+
+    // Préimage de la version d'origine : index + temps + données + sPrevHash + adresse du
+    // validateur. Le Genesis n'y était jamais haché : sPrevHash du bloc 1 restait vide.
+    const Block& block1 = chain.GetBlock(1);
+    const Block& block2 = chain.GetBlock(2);
+    std::string baseline1 = std::to_string(block1.GetIndex()) + std::to_string(block1.GetTime()) +
+                            std::string(block1.GetData()) + "" + std::string(chain.ValidatorOf(1));
+    std::string baseline2 = std::to_string(block2.GetIndex()) + std::to_string(block2.GetTime()) +
+                            std::string(block2.GetData()) + hash_to_hex(block1.hash) +
+                            std::string(chain.ValidatorOf(2));
+    bool bSameHash = sha256_raw(baseline1) == block1.hash && sha256_raw(baseline2) == block2.hash;
+    std::cout << "Hash des blocs 1 et 2 identique a la preimage d'origine : " << (bSameHash ? "oui" : "non")
+              << std::endl;
+
+    // Une allocation par tranche d'arène : bien moins d'une par bloc
+    return bSameHash && chain.IsValidPoS() && bNoRealloc && nChunks <= nBlocks / 100;
+}
+
+/**
+ * @brief Vérifie le ValidatorRegistry (graine fixe, résultat déterministe) :
+ * même graine -> même suite, sommes de l'arbre de Fenwick égales au recalcul
+ * linéaire après UpdateStake, fréquences FENWICK et ALIAS conformes aux parts
+ * d'enjeu (khi-deux).
+ */
+bool verify_validator_registry() {
+    const size_t nValidators = 37;
+    const size_t nDraws = 1000000;
+    // Khi-deux à 35 degrés de liberté (36 enjeux non nuls), seuil p = 0.001
+    const double CHI_SQUARE_LIMIT = 66.62;
+
+    std::mt19937_64 rng(2024);
+    std::vector<double> stakes(nValidators);
+    ValidatorRegistry registry(7);
+    ValidatorRegistry twin(7);
+    for (size_t i = 0; i < nValidators; ++i) {
+        stakes[i] = 1.0 + static_cast<double>(rng() % 500);
+        registry.Add("validateur_" + std::to_string(i), stakes[i]);
+        twin.Add("validateur_" + std::to_string(i), stakes[i]);
+    }
+
+    // 1. Même graine, même suite (dans les deux modes)
+    bool bSameSequence = true;
+    for (ValidatorRegistry::SamplingMode mode : {ValidatorRegistry::SamplingMode::FENWICK,
+                                                 ValidatorRegistry::SamplingMode::ALIAS}) {
+        registry.SetSamplingMode(mode);
+        twin.SetSamplingMode(mode);
+        for (size_t i = 0; i < 10000; ++i) {
+            bSameSequence = bSameSequence && registry.SelectIndex() == twin.SelectIndex();
+        }
+    }
+    std::cout << "Meme graine, meme suite : " << (bSameSequence ? "oui" : "non") << std::endl;
+
+    // 2. UpdateStake : sommes préfixes de l'arbre contre recalcul linéaire (un enjeu mis à zéro)
+    for (size_t k = 0; k < 500; ++k) {
+        size_t i = rng() % nValidators;
+        stakes[i] = static_cast<double>(rng() % 1000) / 4.0;
+        registry.UpdateStake(i, stakes[i]);
+    }
+    stakes[5] = 0.0;
+    registry.UpdateStake(5, 0.0);
+    double maxError = 0.0;
+    double linear = 0.0;
+    for (size_t count = 0; count <= nValidators; ++count) {
+        maxError = std::max(maxError, std::fabs(registry.PrefixStake(count) - linear));
+        if (count < nValidators) {
+            linear += stakes[count];
+        }
+    }
+    maxError = std::max(maxError, std::fabs(registry.TotalStake() - linear));
+    bool bPrefixOk = maxError < 1e-6;
+    std::cout << "Sommes prefixes apres UpdateStake : ecart max " << maxError << std::endl;
+
+    // 3. Fréquences des tirages contre parts d'enjeu
+    bool bFrequenciesOk = true;
+    for (ValidatorRegistry::SamplingMode mode : {ValidatorRegistry::SamplingMode::FENWICK,
+                                                 ValidatorRegistry::SamplingMode::ALIAS}) {
+        registry.SetSamplingMode(mode);
+        std::vector<uint64_t> counts(nValidators, 0);
+        for (size_t d = 0; d < nDraws; ++d) {
+            ++counts[registry.SelectIndex()];
+        }
+        double chiSquare = 0.0;
+        for (size_t i = 0; i < nValidators; ++i) {
+            double expected = nDraws * stakes[i] / linear;
+            if (expected > 0.0) {
+                chiSquare += (counts[i] - expected) * (counts[i] - expected) / expected;
+            }
+        }
+        bool bOk = chiSquare < CHI_SQUARE_LIMIT && counts[5] == 0;
+        std::cout << (mode == ValidatorRegistry::SamplingMode::FENWICK ? "FENWICK" : "ALIAS") << " : khi-deux "
+                  << chiSquare << " (seuil " << CHI_SQUARE_LIMIT << "), enjeu nul tire " << counts[5]
+                  << " fois" << std::endl;
+        bFrequenciesOk = bFrequenciesOk && bOk;
+    }
+    return bSameSequence && bPrefixOk && bFrequenciesOk;
+}
+
+
 int main() {
     // EXEMPLE DE VALIDATION AVEC PROOF OF STAKE
     std::cout << "--- Simulation Proof of Stake (PoS) ---" << std::endl;
@@ -133,7 +362,7 @@ int main() {
     posChain.AddValidator("David", 20);
 
     auto t_start_pos = std::chrono::high_resolution_clock::now();
-    posChain.AddBlockPoS(Block(1, "Transaction Data PoS"));
+    posChain.AddBlockPoS("Transaction Data PoS");
     auto t_end_pos = std::chrono::high_resolution_clock::now();
     double time_taken_pos = std::chrono::duration<double, std::milli>(t_end_pos - t_start_pos).count();
     
@@ -151,7 +380,7 @@ int main() {
 
     auto t_start_pow = std::chrono::high_resolution_clock::now();
     std::cout << "Minage du bloc PoW avec difficulte " << difficulty << "..." << std::endl;
-    powChain.AddBlockPoW(Block(1, "Transaction Data PoW"), difficulty);
+    powChain.AddBlockPoW("Transaction Data PoW", difficulty);
     auto t_end_pow = std::chrono::high_resolution_clock::now();
     double time_taken_pow = std::chrono::duration<double, std::milli>(t_end_pow - t_start_pow).count();
     
@@ -171,6 +400,27 @@ int main() {
     } else {
         std::cout << "\nConclusion : Dans cette simulation, Proof of Work a ete plus rapide (ce qui est inhabituel)." << std::endl;
     }
+
+    std::cout << "\n============================================\n" << std::endl;
+
+    std::cout << "--- Allocations par bloc (arene + StringPool) ---" << std::endl;
+    if (run_allocation_check(1000000)) {
+        std::cout << "VERIFICATION REUSSIE : hash identique a la preimage texte, chaine valide, "
+                  << "moins d'une allocation par bloc." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : hash, chainage ou allocations par bloc incorrects !" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n============================================\n" << std::endl;
+
+    std::cout << "--- Registre des validateurs (Fenwick / alias) ---" << std::endl;
+    if (verify_validator_registry()) {
+        std::cout << "VERIFICATION REUSSIE : tirages reproductibles et conformes aux enjeux." << std::endl;
+    } else {
+        std::cout << "VERIFICATION ECHOUEE : selection des validateurs incorrecte !" << std::endl;
+        return 1;
+    }
     
     return 0;
 }
\ No newline at end of file
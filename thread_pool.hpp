@@ -0,0 +1,123 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class ThreadPool
+ * Pool de threads persistant : les workers sont créés une seule fois et
+ * réutilisés à chaque tâche (minage d'un bloc, validation de la chaîne...).
+ * Les tâches ne doivent pas lever d'exception.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> _vWorkers;
+    std::mutex _mutex;
+    std::condition_variable _cvJob;
+    std::condition_variable _cvDone;
+    const std::function<void(unsigned)>* _pJob;
+    uint64_t _nGeneration; // incrémenté à chaque nouvelle tâche
+    unsigned _nPending;    // workers qui n'ont pas encore fini la tâche courante
+    bool _bStop;
+
+    void _WorkerLoop(unsigned workerId) {
+        uint64_t seenGeneration = 0;
+        for (;;) {
+            const std::function<void(unsigned)>* job;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cvJob.wait(lock, [&] { return _bStop || _nGeneration != seenGeneration; });
+                if (_bStop) {
+                    return;
+                }
+                seenGeneration = _nGeneration;
+                job = _pJob;
+            }
+
+            (*job)(workerId);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_nPending == 0) {
+                _cvDone.notify_one();
+            }
+        }
+    }
+
+public:
+    /**
+     * @param nThreads Nombre de workers (0 = nombre de coeurs de la machine).
+     */
+    explicit ThreadPool(unsigned nThreads = 0)
+        : _pJob(nullptr), _nGeneration(0), _nPending(0), _bStop(false) {
+        if (nThreads == 0) {
+            nThreads = std::thread::hardware_concurrency();
+        }
+        if (nThreads == 0) {
+            nThreads = 1;
+        }
+        _vWorkers.reserve(nThreads);
+        for (unsigned i = 0; i < nThreads; ++i) {
+            _vWorkers.emplace_back(&ThreadPool::_WorkerLoop, this, i);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _bStop = true;
+        }
+        _cvJob.notify_all();
+        for (auto& worker : _vWorkers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned Size() const {
+        return static_cast<unsigned>(_vWorkers.size());
+    }
+
+    /**
+     * @brief Exécute job(workerId) sur chaque worker et attend qu'ils aient tous fini.
+     */
+    void RunOnAll(const std::function<void(unsigned)>& job) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _pJob = &job;
+        _nPending = Size();
+        ++_nGeneration;
+        _cvJob.notify_all();
+        _cvDone.wait(lock, [&] { return _nPending == 0; });
+        _pJob = nullptr;
+    }
+
+    /**
+     * @brief Découpe [0, count) en morceaux de 'chunk' indices distribués
+     * dynamiquement aux workers ; fn(begin, end) traite un morceau.
+     */
+    void ParallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)>& fn) {
+        if (chunk == 0) {
+            chunk = 1;
+        }
+        std::atomic<size_t> next(0);
+        RunOnAll([&](unsigned) {
+            for (;;) {
+                size_t begin = next.fetch_add(chunk, std::memory_order_relaxed);
+                if (begin >= count) {
+                    return;
+                }
+                size_t end = (count - begin < chunk) ? count : begin + chunk;
+                fn(begin, end);
+            }
+        });
+    }
+};
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,227 @@
+#ifndef VALIDATOR_REGISTRY_HPP
+#define VALIDATOR_REGISTRY_HPP
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <stdexcept>
+
+// Structure simple pour représenter un validateur
+struct Validator {
+    std::string address;
+    double stake;
+};
+
+/**
+ * @class AliasTable
+ * Table d'alias de Walker (méthode de Vose) : construction O(n), tirage O(1).
+ * Adaptée quand les enjeux ne changent pas entre deux tirages.
+ */
+class AliasTable {
+private:
+    std::vector<double> _vProb;
+    std::vector<size_t> _vAlias;
+
+public:
+    AliasTable() {}
+
+    explicit AliasTable(const std::vector<double>& weights) {
+        Build(weights);
+    }
+
+    void Build(const std::vector<double>& weights) {
+        const size_t n = weights.size();
+        _vProb.assign(n, 0.0);
+        _vAlias.assign(n, 0);
+        if (n == 0) {
+            return;
+        }
+
+        double total = 0.0;
+        for (double w : weights) { total += w; }
+
+        // Probabilités normalisées à une moyenne de 1 ; petites / grandes séparées.
+        std::vector<double> scaled(n);
+        std::vector<size_t> small, large;
+        for (size_t i = 0; i < n; ++i) {
+            scaled[i] = (total > 0.0) ? weights[i] * n / total : 1.0;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty()) {
+            size_t s = small.back(); small.pop_back();
+            size_t l = large.back(); large.pop_back();
+            _vProb[s] = scaled[s];
+            _vAlias[s] = l;
+            scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+            (scaled[l] < 1.0 ? small : large).push_back(l);
+        }
+        // Restes (erreurs d'arrondi) : probabilité 1
+        for (size_t i : large) { _vProb[i] = 1.0; }
+        for (size_t i : small) { _vProb[i] = 1.0; }
+    }
+
+    bool Empty() const {
+        return _vProb.empty();
+    }
+
+    template <class Rng>
+    size_t Sample(Rng& rng) const {
+        std::uniform_int_distribution<size_t> column(0, _vProb.size() - 1);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        size_t i = column(rng);
+        return coin(rng) < _vProb[i] ? i : _vAlias[i];
+    }
+};
+
+/**
+ * @class ValidatorRegistry
+ * Registre des validateurs pour la sélection PoS pondérée par l'enjeu.
+ *
+ * L'ancienne SelectValidator() sommait tous les enjeux, créait un
+ * std::random_device + std::mt19937 à chaque appel, puis parcourait la liste :
+ * O(n) par bloc plus le coût de l'entropie système. Ici :
+ * - un arbre de Fenwick sur les enjeux donne le tirage pondéré et la mise à
+ *   jour d'un enjeu en O(log n) ;
+ * - en mode ALIAS (enjeux statiques), une table de Walker est reconstruite
+ *   paresseusement après une modification et chaque tirage est en O(1) ;
+ * - un seul générateur, initialisé une fois (graine fixe = mode déterministe).
+ *
+ * Le validateur choisi est le premier dont la somme cumulée des enjeux atteint
+ * le point tiré, comme dans la version linéaire.
+ */
+class ValidatorRegistry {
+public:
+    enum class SamplingMode {
+        FENWICK, // enjeux qui changent souvent
+        ALIAS    // enjeux statiques
+    };
+
+private:
+    std::vector<Validator> _vValidators;
+    std::vector<double> _vTree; // arbre de Fenwick, indices 1..n
+    double _dTotalStake;
+    std::mt19937_64 _rng;
+    SamplingMode _eMode;
+    AliasTable _alias;
+    bool _bAliasDirty;
+
+    // Somme des enjeux des validateurs [0, count)
+    double _PrefixSum(size_t count) const {
+        double sum = 0.0;
+        for (size_t i = count; i > 0; i -= i & (~i + 1)) {
+            sum += _vTree[i];
+        }
+        return sum;
+    }
+
+    // Plus petit index dont la somme cumulée (incluse) est >= target
+    size_t _FindIndex(double target) const {
+        size_t pos = 0;
+        size_t step = 1;
+        while (step * 2 < _vTree.size()) { step *= 2; }
+        for (; step > 0; step /= 2) {
+            if (pos + step < _vTree.size() && _vTree[pos + step] < target) {
+                pos += step;
+                target -= _vTree[pos];
+            }
+        }
+        // Erreur d'arrondi sur le dernier élément : on reste dans les bornes
+        return pos < _vValidators.size() ? pos : _vValidators.size() - 1;
+    }
+
+public:
+    // Graine tirée une seule fois de l'entropie système
+    ValidatorRegistry()
+        : _vTree(1, 0.0), _dTotalStake(0.0), _rng(std::random_device{}()),
+          _eMode(SamplingMode::FENWICK), _bAliasDirty(true) {
+    }
+
+    // Mode déterministe : même graine, même suite de validateurs
+    explicit ValidatorRegistry(uint64_t seed)
+        : _vTree(1, 0.0), _dTotalStake(0.0), _rng(seed),
+          _eMode(SamplingMode::FENWICK), _bAliasDirty(true) {
+    }
+
+    void Seed(uint64_t seed) {
+        _rng.seed(seed);
+    }
+
+    void SetSamplingMode(SamplingMode mode) {
+        _eMode = mode;
+    }
+
+    /**
+     * @brief Ajoute un validateur en O(log n) et retourne son index.
+     */
+    size_t Add(const std::string& address, double stake) {
+        if (stake < 0.0) {
+            throw std::invalid_argument("L'enjeu d'un validateur ne peut pas etre negatif.");
+        }
+        _vValidators.push_back({address, stake});
+        size_t i = _vValidators.size();
+        // Le noeud i couvre ]i - lowbit(i), i] : somme déjà présente + nouvel enjeu
+        size_t lowbit = i & (~i + 1);
+        _vTree.push_back(stake + _PrefixSum(i - 1) - _PrefixSum(i - lowbit));
+        _dTotalStake += stake;
+        _bAliasDirty = true;
+        return i - 1;
+    }
+
+    /**
+     * @brief Change l'enjeu d'un validateur en O(log n).
+     */
+    void UpdateStake(size_t index, double stake) {
+        if (stake < 0.0) {
+            throw std::invalid_argument("L'enjeu d'un validateur ne peut pas etre negatif.");
+        }
+        double delta = stake - _vValidators.at(index).stake;
+        _vValidators[index].stake = stake;
+        for (size_t i = index + 1; i < _vTree.size(); i += i & (~i + 1)) {
+            _vTree[i] += delta;
+        }
+        _dTotalStake += delta;
+        _bAliasDirty = true;
+    }
+
+    // Somme des enjeux des 'count' premiers validateurs, lue dans l'arbre en O(log n)
+    double PrefixStake(size_t count) const {
+        if (count > _vValidators.size()) {
+            throw std::out_of_range("ValidatorRegistry: index hors limites.");
+        }
+        return _PrefixSum(count);
+    }
+
+    size_t Size() const { return _vValidators.size(); }
+    bool Empty() const { return _vValidators.empty(); }
+    double TotalStake() const { return _dTotalStake; }
+
+    Validator& operator[](size_t index) { return _vValidators[index]; }
+    const Validator& operator[](size_t index) const { return _vValidators[index]; }
+
+    /**
+     * @brief Tire l'index d'un validateur avec une probabilité proportionnelle
+     * à son enjeu. Le registre ne doit pas être vide.
+     */
+    size_t SelectIndex() {
+        if (_eMode == SamplingMode::ALIAS) {
+            if (_bAliasDirty) {
+                std::vector<double> stakes(_vValidators.size());
+                for (size_t i = 0; i < stakes.size(); ++i) { stakes[i] = _vValidators[i].stake; }
+                _alias.Build(stakes);
+                _bAliasDirty = false;
+            }
+            return _alias.Sample(_rng);
+        }
+
+        std::uniform_real_distribution<> distrib(0, _dTotalStake);
+        return _FindIndex(distrib(_rng));
+    }
+
+    Validator& Select() {
+        return _vValidators[SelectIndex()];
+    }
+};
+
+#endif // VALIDATOR_REGISTRY_HPP